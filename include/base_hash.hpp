@@ -4,26 +4,88 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <iosfwd>
+#include <random>
+#include <stdexcept>
 
 namespace hashing {
 
 // Construction statistics for tracking hash quality
+//
+// Quality fields (chi_square, max_load, collisions) are only filled by
+// analyzeQuality() in quality_analysis.hpp; builds leave them at zero.
 struct ConstructionStats {
+    static constexpr size_t MAX_REPORTED_DUPLICATES = 100;
+
     size_t attempts = 0;           // Number of construction attempts
-    size_t collisions = 0;         // Collisions encountered during construction
+    size_t collisions = 0;         // Sampled keys sharing an output with another sampled key
     double chi_square = 0.0;       // Chi-square statistic for distribution quality
+    size_t max_load = 0;           // Most sampled keys mapped to one output value
+    size_t quality_sample = 0;     // Keys behind the quality fields (0: not analysed)
+    size_t fallback_keys = 0;      // Keys diverted from BDZ 2-cores (BuildConfig::divert_core)
+    size_t duplicate_keys = 0;     // Input keys equal to an earlier key (see duplicate_keys.hpp)
+    std::vector<size_t> duplicate_positions;  // Input positions of the first of them
     bool success = false;          // Whether construction succeeded
 
     ConstructionStats() = default;
 };
 
-// Abstract base class for all hash models
-class HashModel {
+// Keyed hash applied to every key before the index stages. DEFAULT keeps
+// each model's own choice; the others trade hash-flooding resistance for
+// speed (see keyed_hash.hpp).
+enum class KeyHash : uint8_t {
+    DEFAULT,
+    SIPHASH_2_4,     // Keyed PRF, the conservative choice
+    SIPHASH_1_2,     // Reduced-round SipHash
+    AES,             // AES-NI rounds (requires an AES-capable build)
+    WIDE_MULTIPLY    // 64x64->128 multiply-and-fold, fastest
+};
+
+// Build parameters shared by all models (models ignore what they don't use)
+struct BuildConfig {
+    double table_factor = 1.23;     // MPHF vertices per key (1 / load factor)
+    unsigned fingerprint_bits = 0;  // Width of stored verification fingerprints (0: model default)
+    unsigned num_threads = 1;       // Worker threads for per-key passes
+    bool cache_local = false;       // BDZ: two of each key's three vertices in one cache line
+    bool divert_core = false;       // BDZ: one peel; keys left in the 2-core go to a secondary
+                                    // table instead of a retry with a new seed
+    bool deduplicate = false;       // Drop repeated keys instead of failing the build
+    bool exact = false;             // Pipelines: store the keys, compare them on lookup
+    KeyHash key_hash = KeyHash::DEFAULT;  // Preprocessing hash of the pipeline hybrids
+
+    // With `seeded` set, the same keys and seed give a byte-identical index
+    // regardless of num_threads; otherwise each build draws a fresh seed
+    bool seeded = false;
+    uint64_t seed = 0;
+
+    BuildConfig() = default;
+};
+
+// Abstract base class for all hash models, over keys of type Key.
+//
+// Most models hash std::string keys (HashModel below). Fixed-width keys,
+// integers and std::array<uint8_t, N>, are hashed directly by the pipeline
+// models of fixed_key_models.hpp, without formatting them as strings.
+template <typename Key>
+class BasicHashModel {
 public:
-    virtual ~HashModel() = default;
+    virtual ~BasicHashModel() = default;
     virtual std::string getName() const = 0;
-    virtual void build(const std::vector<std::string>& keys) = 0;
-    virtual uint64_t hash(const std::string& key) const = 0;
+    virtual void build(const std::vector<Key>& keys) = 0;
+
+    // Build, releasing the keys as early as the model allows. Models that
+    // hash each key once into signatures free the keys before the MPHF is
+    // constructed; the default frees them after build().
+    virtual void buildAndRelease(std::vector<Key>&& keys) {
+        build(keys);
+        std::vector<Key>().swap(keys);
+    }
+    virtual uint64_t hash(const Key& key) const = 0;
+
+    // Bound on hash() outputs for keys in the set (0: the key count, as for
+    // a minimal perfect hash)
+    virtual uint64_t outputRange() const { return 0; }
+
     virtual size_t getMemoryUsage() const = 0;
     virtual void printStats() const = 0;
 
@@ -31,8 +93,36 @@ public:
     virtual ConstructionStats getConstructionStats() const {
         return ConstructionStats();  // Default implementation returns empty stats
     }
+
+    // Parameters used by the next build()
+    void configure(const BuildConfig& config) { build_config = config; }
+    const BuildConfig& getBuildConfig() const { return build_config; }
+
+    // Serialization of a built index (models that support it override both)
+    virtual void save(std::ostream& out) const {
+        (void)out;
+        throw std::runtime_error(getName() + " does not support serialization");
+    }
+    virtual void load(std::istream& in) {
+        (void)in;
+        throw std::runtime_error(getName() + " does not support serialization");
+    }
+
+protected:
+    BuildConfig build_config;
+
+    // Source of every random choice a build makes (keys, seeds, retries)
+    std::mt19937_64 build_rng() const {
+        if (build_config.seeded) {
+            return std::mt19937_64(build_config.seed);
+        }
+        std::random_device rd;
+        return std::mt19937_64((static_cast<uint64_t>(rd()) << 32) ^ rd());
+    }
 };
 
+using HashModel = BasicHashModel<std::string>;
+
 } // namespace hashing
 
 #endif // BASE_HASH_HPP
@@ -6,7 +6,7 @@
 namespace hashing {
 
 // SHA-256 implementation for baseline cryptographic hashing
-class BasicCryptoHash : public HashModel {
+class BasicCryptoHash final : public HashModel {
 private:
     static const uint32_t K[64];
     
@@ -2,25 +2,53 @@
 #define BASIC_PERFECT_HASH_HPP
 
 #include "base_hash.hpp"
-#include <unordered_map>
+#include "huge_page_allocator.hpp"
+#include <vector>
+#include <cstdint>
 
 namespace hashing {
 
-// Two-level perfect hashing (Fredman, Komlós, Szemerédi)
-class BasicPerfectHash : public HashModel {
+// Two-level perfect hashing (Fredman, Komlós, Szemerédi), flat layout
+//
+// Each key is hashed once to a 64-bit signature. Signatures are counting-
+// sorted into n first-level buckets; bucket i gets n_i^2 second-level slots
+// and a seed that places its keys without collisions. The primary seed is
+// redrawn until the second-level space stays within ~2n slots.
+//
+// Layout: one contiguous bucket array (seed + slot offset) and one
+// contiguous slot array (occupancy bits + rank), so hash() touches two
+// cache lines and returns a dense index in [0, n). Keys outside the set
+// return UINT64_MAX when they land in an empty bucket or slot, otherwise
+// some index (no verification).
+class BasicPerfectHash final : public HashModel {
 private:
-    struct SecondLevel {
-        std::vector<std::string> table;
-        uint64_t seed;
-        size_t size;
+    static constexpr double MAX_SLOTS_PER_KEY = 2.2;
+    static constexpr int MAX_PRIMARY_ATTEMPTS = 100;
+    static constexpr int MAX_BUCKET_ATTEMPTS = 1000;
+
+    uint64_t signature_seed = 0;
+    uint64_t primary_seed = 0;
+    size_t num_keys = 0;
+
+    // Seed and first slot per bucket, interleaved so a lookup reads one
+    // cache line; a sentinel entry holds the end offset
+    struct Bucket {
+        uint32_t offset;
+        uint32_t seed;
     };
-    
-    std::vector<SecondLevel> first_level;
-    size_t num_keys;
-    uint64_t primary_seed;
-    
-    uint64_t hash_function(const std::string& key, uint64_t seed) const;
-    bool build_second_level(size_t index, const std::vector<std::string>& bucket_keys);
+    HugeVector<Bucket> buckets;
+
+    // Per 32 slots: occupancy bits (low half), occupied slots before them (high half)
+    HugeVector<uint64_t> slot_words;
+
+    ConstructionStats construction_stats;
+
+    uint64_t signature(const std::string& key) const;
+    size_t num_buckets() const { return buckets.empty() ? 0 : buckets.size() - 1; }
+    size_t bucket_of(uint64_t sig) const;
+    static size_t slot_of(uint64_t sig, uint32_t seed, size_t size);
+    bool build_buckets(const std::vector<uint64_t>& sigs, std::mt19937_64& gen);
+    bool place_bucket(size_t bucket, const uint64_t* sigs, size_t n, std::mt19937_64& gen);
     
 public:
     std::string getName() const override { return "Basic Perfect Hash (FKS)"; }
@@ -28,6 +56,7 @@ public:
     uint64_t hash(const std::string& key) const override;
     size_t getMemoryUsage() const override;
     void printStats() const override;
+    ConstructionStats getConstructionStats() const override { return construction_stats; }
 };
 
 } // namespace hashing
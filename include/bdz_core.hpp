@@ -0,0 +1,147 @@
+#ifndef BDZ_CORE_HPP
+#define BDZ_CORE_HPP
+
+#include "huge_page_allocator.hpp"
+#include <vector>
+#include <cstdint>
+#include <iosfwd>
+
+namespace hashing {
+
+// Signature-driven BDZ minimal perfect hash.
+//
+// Builds from 64-bit key signatures instead of strings, so a caller hashes
+// each key once and never needs the strings during construction. Peeling
+// keeps only a degree byte and the XOR of incident edge ids per vertex
+// (no adjacency lists), about 20 bytes per key at peak.
+//
+// Layout: the table is split into three equal segments and each key has one
+// vertex per segment. g values take 2 bits per vertex, 3 marks an unused
+// vertex. A lookup selects vertex h[(g0 + g1 + g2) mod 3] and ranks it among
+// used vertices, giving a dense index in [0, n).
+//
+// The BLOCKED layout cuts the table into 256-vertex blocks (one 64-byte line
+// of 2-bit values, which is also one rank sample). A key's first two
+// vertices lie in the two halves of one block and the third in any other
+// block, so a lookup touches two cache lines instead of three and the rank
+// of a vertex in the key's block reads no further line. Keeping all three
+// vertices within a line or two is not viable: with ~200 keys per block,
+// keys with identical vertex triples appear once tables reach ~10^5 keys
+// and no seed peels them. The two-plus-one graph peels at the same load.
+//
+// The TERNARY encoding packs 5 g values per byte (3^5 = 243) and decodes
+// them through a 256-entry table: 1.6 bits per vertex instead of 2, with no
+// rank directory. Without the unused marker a vertex cannot be ranked, so
+// lookup returns the selected vertex itself, a perfect but not minimal
+// index in [0, tableSize()). It suits users that store nothing per index.
+//
+// With `divert_core`, a build whose peel stops at a non-empty 2-core keeps
+// the peeled keys and moves the rest into a secondary BDZCore at a lower
+// load, where retries are cheap. Every vertex of a 2-core key stays unused
+// (3), so such a key always selects an unused vertex and lookup continues in
+// the secondary table, at index (peeled keys) + (secondary index). The
+// index stays minimal and the main table needs one seed. TWO_BIT only:
+// TERNARY has no unused marker to route on.
+class BDZCore {
+public:
+    static constexpr uint64_t NOT_FOUND = UINT64_MAX;
+    static constexpr double FALLBACK_TABLE_FACTOR = 1.5;  // Secondary table: vertices per key
+    static constexpr int FALLBACK_ATTEMPTS = 100;
+
+    enum class GEncoding : uint8_t {
+        TWO_BIT,  // Minimal: index in [0, n)
+        TERNARY   // Perfect: index in [0, tableSize()), ~20% smaller
+    };
+
+    enum class Layout : uint8_t {
+        UNIFORM,  // One vertex per table third: three lines per lookup
+        BLOCKED   // Two vertices in one 256-vertex block: two lines per lookup
+    };
+
+    // Single construction attempt; returns false if the hypergraph for this
+    // seed is not peelable (caller retries with a new seed, unless
+    // equalSignatures()). With divert_core (TWO_BIT only) a 2-core goes to
+    // the secondary table and only equal signatures (or a vertex of degree
+    // 256) fail.
+    bool build(const uint64_t* signatures, size_t n, uint64_t seed, double table_factor,
+               GEncoding encoding = GEncoding::TWO_BIT, Layout layout = Layout::UNIFORM,
+               bool divert_core = false);
+
+    // Index of the key with this signature, or NOT_FOUND when the selected
+    // vertex is unused (only possible for keys outside the set, and only
+    // with the TWO_BIT encoding)
+    uint64_t lookup(uint64_t signature) const;
+
+    // out[i] = lookup(signatures[i]). With AVX-512 (8 lanes) or AVX2 (4
+    // lanes) the vertex hashing, range reductions, g gathers and selection
+    // run for a group of signatures at once; ranking stays per key.
+    void lookupBatch(const uint64_t* signatures, size_t n, uint64_t* out) const;
+
+    // Start loading the g lines and rank samples lookup(signature) will read
+    void prefetch(uint64_t signature) const;
+
+    // The last build failed on two keys with the same signature: they share
+    // all three vertices under every seed, so retrying cannot succeed
+    bool equalSignatures() const { return equal_signatures; }
+
+    size_t numKeys() const { return num_keys; }
+    size_t fallbackKeys() const { return fallback.empty() ? 0 : fallback.front().numKeys(); }
+    size_t tableSize() const { return table_size; }
+    GEncoding encoding() const { return g_encoding; }
+    Layout layout() const { return vertex_layout; }
+
+    // Bound on lookup() results for keys in the set
+    size_t range() const { return g_encoding == GEncoding::TERNARY ? tableSize() : num_keys; }
+    size_t sizeInBytes() const;
+
+    void save(std::ostream& out) const;
+    void load(std::istream& in);
+
+private:
+    static constexpr size_t VERTICES_PER_WORD = 32;
+    static constexpr size_t WORDS_PER_LINE = 8;
+    static constexpr size_t VERTICES_PER_LINE = VERTICES_PER_WORD * WORDS_PER_LINE;
+    static constexpr size_t VERTICES_PER_RANK_SAMPLE = VERTICES_PER_LINE;
+    static constexpr size_t VERTICES_PER_BYTE = 5;  // TERNARY
+    static constexpr size_t BLOCK_VERTICES = VERTICES_PER_LINE;  // BLOCKED
+
+    // One cache line of 2-bit g values; a rank sample covers exactly one
+    struct alignas(64) GLine {
+        uint64_t words[WORDS_PER_LINE];
+    };
+    static_assert(sizeof(GLine) == 64, "GLine must fill one cache line");
+
+    HugeVector<GLine> g_lines;           // TWO_BIT: 256 vertices per line
+    HugeVector<uint32_t> rank_samples;   // TWO_BIT: used vertices before each 256-vertex block
+    HugeVector<uint8_t> g_trits;         // TERNARY: 5 base-3 g values per byte
+    std::vector<BDZCore> fallback;       // Diverted 2-core keys: none, or one secondary table
+    GEncoding g_encoding = GEncoding::TWO_BIT;
+    Layout vertex_layout = Layout::UNIFORM;
+    size_t num_keys = 0;
+    size_t table_size = 0;
+    size_t segment_size = 0;  // UNIFORM: table_size / 3
+    size_t num_blocks = 0;    // BLOCKED: table_size / BLOCK_VERTICES
+    uint64_t seed = 0;
+    bool equal_signatures = false;
+
+    void vertices(uint64_t signature, size_t v[3]) const;
+    void lookup_group(const uint64_t* signatures, uint64_t* out) const;  // One SIMD group
+    uint64_t select_ternary(const size_t v[3]) const;
+    uint64_t lookup_fallback(uint64_t signature) const;  // For keys selecting an unused vertex
+    bool build_fallback(const std::vector<uint64_t>& core_signatures, Layout layout);
+    uint64_t rank(size_t selected) const {
+        return rank_samples[selected / VERTICES_PER_LINE] + rank_in_line(selected);
+    }
+    uint8_t get_g(size_t v) const {
+        const uint64_t word = g_lines[v / VERTICES_PER_LINE].words[(v / VERTICES_PER_WORD) % WORDS_PER_LINE];
+        return (word >> ((v % VERTICES_PER_WORD) * 2)) & 0x03;
+    }
+    void set_g(size_t v, uint8_t value);
+    uint64_t rank_in_line(size_t v) const;
+    void pack_ternary();
+    void set_table_size(size_t size);
+};
+
+} // namespace hashing
+
+#endif // BDZ_CORE_HPP
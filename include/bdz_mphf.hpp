@@ -2,25 +2,35 @@
 #define BDZ_MPHF_HPP
 
 #include "base_hash.hpp"
+#include "huge_page_allocator.hpp"
 #include <vector>
 
 namespace hashing {
 
 // BDZ Minimal Perfect Hash Function
 // Reference: Belazzougui, Botelho, Dietzfelbinger (2009)
-class BDZ_MPHF : public HashModel {
+//
+// Each key is an edge over three vertices, one per third of the table. The
+// 2-bit g value of a used vertex (3 marks an unused one) makes
+// (g0 + g1 + g2) mod 3 select the vertex a key was peeled at; its rank
+// among used vertices is the key's index in [0, n). In-memory only: the
+// serializable BDZ is BDZPipelineMPHF.
+class BDZ_MPHF final : public HashModel {
 private:
-    std::vector<uint8_t> g_values;  // 2-bit values packed
-    size_t num_keys;
-    size_t table_size;
-    uint64_t seeds[3];
+    static constexpr size_t VERTICES_PER_BLOCK = 256;   // One rank sample per 64 bytes of g
+
+    HugeVector<uint8_t> g_values;  // 2-bit values packed
+    HugeVector<uint64_t> rank_samples;  // Used vertices before each block
+    size_t num_keys = 0;
+    size_t table_size = 0;
+    uint64_t seeds[3] = {};
     ConstructionStats construction_stats;
 
     void compute_three_hashes(const std::string& key, size_t& h0, size_t& h1, size_t& h2) const;
     bool build_graph_and_assign(const std::vector<std::string>& keys);
     uint8_t get_g_value(size_t index) const;
     void set_g_value(size_t index, uint8_t value);
-    double compute_chi_square(const std::vector<std::string>& keys) const;
+    uint64_t rank(size_t vertex) const;
 
 public:
     std::string getName() const override { return "BDZ Minimal Perfect Hash"; }
@@ -0,0 +1,21 @@
+#ifndef BDZ_PIPELINE_MPHF_HPP
+#define BDZ_PIPELINE_MPHF_HPP
+
+#include "hybrid_pipeline.hpp"
+
+namespace hashing {
+
+// BDZ MPHF as an index model: SipHash-2-4 + BDZCore (vertex selection and
+// rank directory), so keys map to [0, n); no verification, keys outside
+// the set map to arbitrary slots. This is the `bdz` model of mphf_build and
+// the index files; BDZ_MPHF stays the textbook model of the benchmarks.
+using BDZPipeline = HybridPipeline<SipHash24Preprocessor, NoFilter, BDZIndex, NoVerifier>;
+
+class BDZPipelineMPHF final : public BDZPipeline {
+public:
+    std::string getName() const override { return "BDZ MPHF (SipHash-2-4 + BDZCore)"; }
+};
+
+} // namespace hashing
+
+#endif // BDZ_PIPELINE_MPHF_HPP
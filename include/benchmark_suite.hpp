@@ -9,6 +9,7 @@
 #include <random>
 #include <cstdint>
 #include "base_hash.hpp"
+#include "lookup.hpp"
 
 namespace benchmark {
 
@@ -76,9 +77,12 @@ private:
     std::vector<BenchmarkResult> results_;
     
 public:
-    // Benchmark a single algorithm
+    // Benchmark a single algorithm. Instantiated with the concrete model
+    // type, the lookup loop is statically dispatched (see lookup.hpp);
+    // with HashModel it goes through the virtual hash().
+    template <typename Model>
     BenchmarkResult runBenchmark(
-        hashing::HashModel* model,
+        Model* model,
         const std::vector<std::string>& keys,
         KeyDistribution dist
     ) {
@@ -101,11 +105,10 @@ public:
         
         // Measure lookup time
         auto lookup_start = std::chrono::high_resolution_clock::now();
-        for (const auto& key : keys) {
-            volatile uint64_t hash_val = model->hash(key);
-            (void)hash_val; // Prevent optimization
-        }
+        uint64_t checksum = hashing::lookupChecksum(*model, keys);
         auto lookup_end = std::chrono::high_resolution_clock::now();
+        volatile uint64_t sink = checksum; // Prevent optimization
+        (void)sink;
         
         std::chrono::duration<double, std::milli> lookup_duration = lookup_end - lookup_start;
         double lookup_time_sec = lookup_duration.count() / 1000.0;
@@ -0,0 +1,244 @@
+#ifndef COROUTINE_LOOKUP_HPP
+#define COROUTINE_LOOKUP_HPP
+
+// Coroutine-interleaved lookups (build with -DHASHING_COROUTINES=ON, C++20).
+//
+// A hybrid lookup is a chain of dependent loads: Bloom words, then g-table
+// lines, then the fingerprint at the resulting slot. hashBatch() overlaps
+// them with fixed stages, which wastes work when keys take different paths
+// (a Bloom miss needs no g-table load, a sampled verifier skips the
+// fingerprint). Here each lookup is a coroutine that issues a prefetch and
+// suspends before every dependent load; the scheduler keeps a group of
+// lookups in flight and resumes them round-robin, starting the next key in
+// a slot as soon as its lookup finishes. Each lookup only suspends for the
+// loads it actually makes.
+//
+// Models opt in with `LookupTask hashCoroutine(const std::string&) const`
+// (the pipeline hybrids, TwoPathHybrid, HybridPerfectVerify).
+
+#ifdef HASHING_COROUTINES
+
+#if !defined(__cpp_impl_coroutine)
+    #error "HASHING_COROUTINES requires a C++20 compiler with coroutine support"
+#endif
+
+#include <coroutine>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace hashing {
+
+namespace detail {
+
+// Per-thread free lists of coroutine frames in 64-byte size classes, so a
+// lookup does not pay a malloc/free pair. Free frames are linked through
+// their first word. Frames above the largest class use operator new.
+class FramePool {
+public:
+    static constexpr size_t CLASS_BYTES = 64;
+    static constexpr size_t NUM_CLASSES = 16;
+
+    static void* allocate(size_t bytes) {
+        size_t c = size_class(bytes);
+        if (c >= NUM_CLASSES) return ::operator new(bytes);
+        FramePool& pool = instance();
+        FreeFrame* frame = pool.heads[c];
+        if (!frame) return ::operator new((c + 1) * CLASS_BYTES);
+        pool.heads[c] = frame->next;
+        pool.counts[c]--;
+        return frame;
+    }
+
+    static void release(void* p, size_t bytes) noexcept {
+        size_t c = size_class(bytes);
+        if (c < NUM_CLASSES) {
+            FramePool& pool = instance();
+            if (pool.counts[c] < MAX_CACHED) {
+                pool.heads[c] = new (p) FreeFrame{pool.heads[c]};
+                pool.counts[c]++;
+                return;
+            }
+        }
+        ::operator delete(p);
+    }
+
+private:
+    static constexpr size_t MAX_CACHED = 256;  // Frames kept per class
+
+    struct FreeFrame {
+        FreeFrame* next;
+    };
+
+    FreeFrame* heads[NUM_CLASSES] = {};
+    size_t counts[NUM_CLASSES] = {};
+
+    FramePool() = default;
+    ~FramePool() {
+        for (FreeFrame* head : heads) {
+            while (head) {
+                FreeFrame* next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+        }
+    }
+
+    static size_t size_class(size_t bytes) { return (bytes - 1) / CLASS_BYTES; }
+
+    static FramePool& instance() {
+        static thread_local FramePool pool;
+        return pool;
+    }
+};
+
+} // namespace detail
+
+// A suspended lookup. Created suspended; resume() runs it to the next
+// prefetch (or to the end), result() is valid once done().
+class LookupTask {
+public:
+    struct promise_type {
+        uint64_t value = UINT64_MAX;
+
+        LookupTask get_return_object() {
+            return LookupTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_value(uint64_t v) noexcept { value = v; }
+        void unhandled_exception() noexcept { std::terminate(); }  // Lookups do not throw
+
+        static void* operator new(size_t bytes) { return detail::FramePool::allocate(bytes); }
+        static void operator delete(void* p, size_t bytes) noexcept {
+            detail::FramePool::release(p, bytes);
+        }
+    };
+
+    LookupTask() = default;
+    LookupTask(LookupTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    LookupTask& operator=(LookupTask&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    LookupTask(const LookupTask&) = delete;
+    LookupTask& operator=(const LookupTask&) = delete;
+    ~LookupTask() {
+        if (handle) handle.destroy();
+    }
+
+    bool valid() const { return static_cast<bool>(handle); }
+    bool done() const { return handle.done(); }
+    void resume() const { handle.resume(); }
+    uint64_t result() const { return handle.promise().value; }
+
+    // Run to completion without interleaving
+    uint64_t get() const {
+        while (!handle.done()) handle.resume();
+        return result();
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit LookupTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+};
+
+// Awaited right after issuing a prefetch: gives the load time to land
+// while the scheduler runs the other lookups in the group
+using PrefetchSuspend = std::suspend_always;
+
+// Lookups kept in flight by the scheduler. Enough to cover DRAM latency
+// with 2-3 suspensions per lookup, few enough that the frames stay in L1.
+constexpr size_t DEFAULT_LOOKUP_GROUP = 16;
+
+namespace detail {
+
+template <typename Model, typename = void>
+struct has_hash_coroutine : std::false_type {};
+
+template <typename Model>
+struct has_hash_coroutine<Model, std::void_t<decltype(std::declval<const Model&>().hashCoroutine(
+    std::declval<const std::string&>()))>> : std::true_type {};
+
+// Runs hashCoroutine(keys[i]) for all i with up to `group` in flight and
+// calls sink(i, hash) as each finishes (not in key order)
+template <typename Model, typename Sink>
+void interleave(const Model& model, const std::string* keys, size_t n, size_t group, Sink sink) {
+    static_assert(has_hash_coroutine<Model>::value, "Model has no hashCoroutine()");
+    if (group == 0) group = 1;
+
+    struct Slot {
+        LookupTask task;
+        size_t key = 0;
+    };
+    std::vector<Slot> slots(group < n ? group : n);
+    size_t next = 0;
+    size_t active = 0;
+
+    // Start the next key in a slot; lookups that finish without
+    // suspending are handed to the sink at once
+    auto start = [&](Slot& slot) {
+        while (next < n) {
+            slot.key = next++;
+            slot.task = model.hashCoroutine(keys[slot.key]);
+            slot.task.resume();
+            if (!slot.task.done()) return true;
+            sink(slot.key, slot.task.result());
+        }
+        slot.task = LookupTask();
+        return false;
+    };
+
+    for (Slot& slot : slots) {
+        if (start(slot)) active++;
+    }
+    while (active > 0) {
+        for (Slot& slot : slots) {
+            if (!slot.task.valid()) continue;
+            slot.task.resume();
+            if (slot.task.done()) {
+                sink(slot.key, slot.task.result());
+                if (!start(slot)) active--;
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+// out[i] = hash(keys[i]), with up to `group` coroutine lookups interleaved
+template <typename Model>
+void lookupInterleaved(const Model& model, const std::string* keys, size_t n, uint64_t* out,
+                       size_t group = DEFAULT_LOOKUP_GROUP) {
+    detail::interleave(model, keys, n, group, [out](size_t i, uint64_t h) { out[i] = h; });
+}
+
+// XOR of hash(keys[i]) over the range, interleaved as above
+template <typename Model>
+uint64_t interleavedChecksum(const Model& model, const std::string* keys, size_t n,
+                             size_t group = DEFAULT_LOOKUP_GROUP) {
+    uint64_t checksum = 0;
+    detail::interleave(model, keys, n, group, [&checksum](size_t, uint64_t h) { checksum ^= h; });
+    return checksum;
+}
+
+template <typename Model>
+uint64_t interleavedChecksum(const Model& model, const std::vector<std::string>& keys,
+                             size_t group = DEFAULT_LOOKUP_GROUP) {
+    return interleavedChecksum(model, keys.data(), keys.size(), group);
+}
+
+} // namespace hashing
+
+#endif // HASHING_COROUTINES
+
+#endif // COROUTINE_LOOKUP_HPP
@@ -2,35 +2,71 @@
 #define CUCKOO_PERFECT_HASH_HPP
 
 #include "base_hash.hpp"
-#include <optional>
+#include "cuckoo_table.hpp"
+#include "huge_page_allocator.hpp"
+#include <vector>
+#include <cstdint>
 
 namespace hashing {
 
-// Cuckoo-based perfect hashing with d-ary cuckoo approach
-class CuckooPerfectHash : public HashModel {
-private:
-    static constexpr size_t NUM_TABLES = 3;
-    static constexpr size_t MAX_ITERATIONS = 500;
-    
-    struct Slot {
-        std::string key;
-        bool occupied;
-    };
-    
-    std::vector<std::vector<Slot>> tables;
-    uint64_t seeds[NUM_TABLES];
-    size_t num_keys;
-    size_t table_size;
-    
-    size_t hash_to_table(const std::string& key, size_t table_idx) const;
-    bool insert_with_rehash(const std::string& key);
-    
+// Bucketized cuckoo index with exact membership
+//
+// A CuckooTable (two candidate buckets per key, one 64-byte line of 16-bit
+// tags and 32-bit values per bucket) maps each key's MurmurHash3 to the
+// offset of its record in a contiguous key arena. A record holds the key's
+// length, its index and its bytes, so hash() returns the key's position in
+// the build input (a dense index in [0, n)) and rejects every other key
+// after a single string compare.
+//
+// Lookup: one MurmurHash3 pass, a SIMD compare of the key's tag against
+// both buckets, then one arena record read per tag match (almost always
+// exactly one). Tables are built at ~95% load.
+//
+// Unlike the MPHF models the table is updatable: insert() appends keys
+// after build(), growing the table when no free slot is reachable.
+class CuckooPerfectHash final : public HashModel {
 public:
+    static constexpr double TARGET_LOAD = 0.95;
+
     std::string getName() const override { return "Cuckoo Perfect Hash"; }
     void build(const std::vector<std::string>& keys) override;
     uint64_t hash(const std::string& key) const override;
     size_t getMemoryUsage() const override;
     void printStats() const override;
+    ConstructionStats getConstructionStats() const override { return construction_stats; }
+    void save(std::ostream& out) const override;
+    void load(std::istream& in) override;
+
+    // Add a key; returns its index (the existing one if already present)
+    uint64_t insert(const std::string& key);
+
+    size_t size() const { return num_keys; }
+    double loadFactor() const;
+
+private:
+    static constexpr int MAX_BUILD_ATTEMPTS = 20;
+    static constexpr double BUILD_GROWTH = 1.05;   // Per failed build attempt
+    static constexpr double INSERT_GROWTH = 1.5;   // When insert() finds no slot
+
+    CuckooTable table;
+    uint64_t seed = 0;
+    size_t num_keys = 0;
+
+    // Key arena: per key, in index order, a RecordHeader and the key bytes
+    struct RecordHeader {
+        uint32_t length;
+        uint32_t index;
+    };
+    HugeVector<char> arena;
+
+    ConstructionStats construction_stats;
+
+    uint64_t key_hash(const char* data, size_t len) const;
+    RecordHeader record_at(uint32_t offset) const;
+    uint64_t find(const char* data, size_t len, uint64_t h) const;
+    uint32_t append_key(const std::string& key);
+    bool rebuild(size_t num_buckets, uint64_t new_seed);
+    void clear();
 };
 
 } // namespace hashing
@@ -0,0 +1,165 @@
+#ifndef CUCKOO_TABLE_HPP
+#define CUCKOO_TABLE_HPP
+
+#include "hash_util.hpp"
+#include "huge_page_allocator.hpp"
+#include "murmur_hash.hpp"
+#include <vector>
+#include <cstdint>
+#include <iosfwd>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define CUCKOO_TABLE_SSE2 1
+#endif
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace hashing {
+
+// Signature-driven bucketized cuckoo table.
+//
+// Maps 64-bit key hashes to 32-bit values. Each hash has two candidate
+// buckets of SLOTS_PER_BUCKET slots; a bucket is one 64-byte cache line of
+// 16-bit tags and 32-bit values. The table stores no keys: find() hands
+// every value whose tag matches to the caller's predicate, which decides
+// (arena compare, fingerprint check) whether it belongs to the key.
+//
+// Hash bits: the low 32 select the primary bucket, the top 16 are the tag.
+// The second bucket is derived from the first and the tag (partial-key
+// cuckoo), so entries move without their hashes. Insertion searches
+// breadth-first for the shortest chain of moves to a free slot, which
+// fills tables to ~95%.
+class CuckooTable {
+public:
+    static constexpr size_t SLOTS_PER_BUCKET = 8;
+    static constexpr uint64_t NOT_FOUND = UINT64_MAX;
+
+    // Empty table of num_buckets buckets
+    void reset(size_t num_buckets);
+
+    // False when no free slot is reachable (caller grows or rebuilds)
+    bool insert(uint64_t h, uint32_t value);
+
+    // First value in h's buckets with h's tag for which match(value) holds
+    template <typename Match>
+    uint64_t find(uint64_t h, Match match) const {
+        if (buckets.empty()) return NOT_FOUND;
+
+        uint16_t tag = tag_of(h);
+        size_t b1 = primary_bucket(h);
+        size_t b2 = alternate_bucket(b1, tag);
+
+        // Both buckets are loaded before either is inspected
+        uint32_t m1 = tag_matches(buckets[b1], tag);
+        uint32_t m2 = b2 == b1 ? 0 : tag_matches(buckets[b2], tag);
+
+        for (; m1; m1 &= m1 - 1) {
+            uint32_t value = buckets[b1].values[lowest_bit(m1)];
+            if (match(value)) return value;
+        }
+        for (; m2; m2 &= m2 - 1) {
+            uint32_t value = buckets[b2].values[lowest_bit(m2)];
+            if (match(value)) return value;
+        }
+        return NOT_FOUND;
+    }
+
+    // Start loading both candidate buckets
+    void prefetch(uint64_t h) const {
+        if (buckets.empty()) return;
+        size_t b1 = primary_bucket(h);
+        prefetch_bucket(&buckets[b1]);
+        prefetch_bucket(&buckets[alternate_bucket(b1, tag_of(h))]);
+    }
+
+    // Call visit(value) for every occupied slot
+    template <typename Visit>
+    void forEachValue(Visit visit) const {
+        for (const Bucket& bucket : buckets) {
+            for (size_t i = 0; i < SLOTS_PER_BUCKET; i++) {
+                if (bucket.tags[i] != EMPTY_TAG) visit(bucket.values[i]);
+            }
+        }
+    }
+
+    size_t numBuckets() const { return buckets.size(); }
+    size_t capacity() const { return buckets.size() * SLOTS_PER_BUCKET; }
+    size_t sizeInBytes() const { return buckets.size() * sizeof(Bucket); }
+
+    void save(std::ostream& out) const;
+    void load(std::istream& in);
+
+private:
+    static constexpr uint16_t EMPTY_TAG = 0;
+    static constexpr size_t MAX_BFS_NODES = 1024;
+    static constexpr int MAX_INSERT_ATTEMPTS = 4;
+
+    struct alignas(64) Bucket {
+        uint16_t tags[SLOTS_PER_BUCKET];
+        uint32_t values[SLOTS_PER_BUCKET];
+        uint8_t padding[64 - SLOTS_PER_BUCKET * 6];  // Zeroed, so saved indexes are deterministic
+    };
+    static_assert(sizeof(Bucket) == 64, "Bucket must fill one cache line");
+
+    HugeVector<Bucket> buckets;
+
+    static uint16_t tag_of(uint64_t h) {
+        uint16_t tag = static_cast<uint16_t>(h >> 48);
+        return tag == EMPTY_TAG ? 1 : tag;
+    }
+
+    size_t primary_bucket(uint64_t h) const {
+        return fastrange32(static_cast<uint32_t>(h), buckets.size());
+    }
+
+    // (x - bucket) mod m with x derived from the tag: applying it twice
+    // gives back the original bucket, for any table size
+    size_t alternate_bucket(size_t bucket, uint16_t tag) const {
+        size_t m = buckets.size();
+        size_t x = fastrange32(static_cast<uint32_t>(MurmurHash3::fmix64(tag)), m);
+        return x >= bucket ? x - bucket : x + m - bucket;
+    }
+
+    // Bit i set when slot i holds `tag`
+    static uint32_t tag_matches(const Bucket& bucket, uint16_t tag) {
+        static_assert(SLOTS_PER_BUCKET == 8, "SIMD tag compare assumes 8 x 16-bit tags");
+#ifdef CUCKOO_TABLE_SSE2
+        __m128i tags = _mm_load_si128(reinterpret_cast<const __m128i*>(bucket.tags));
+        __m128i eq = _mm_cmpeq_epi16(tags, _mm_set1_epi16(static_cast<short>(tag)));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(eq, _mm_setzero_si128())));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < SLOTS_PER_BUCKET; i++) {
+            mask |= uint32_t(bucket.tags[i] == tag) << i;
+        }
+        return mask;
+#endif
+    }
+
+    static unsigned lowest_bit(uint32_t x) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, x);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(x));
+#endif
+    }
+
+    static void prefetch_bucket(const Bucket* bucket) {
+#ifdef _MSC_VER
+        (void)bucket;
+#else
+        __builtin_prefetch(bucket, 0, 1);
+#endif
+    }
+
+    bool try_insert(uint64_t h, uint32_t value, bool& path_stale);
+};
+
+} // namespace hashing
+
+#endif // CUCKOO_TABLE_HPP
@@ -0,0 +1,134 @@
+#ifndef DUPLICATE_KEYS_HPP
+#define DUPLICATE_KEYS_HPP
+
+#include "base_hash.hpp"
+#include "key_arena.hpp"
+#include "key_signature.hpp"
+#include "murmur_hash.hpp"
+#include "parallel.hpp"
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iostream>
+#include <cstdint>
+
+namespace hashing {
+
+// Repeated keys in a build's input.
+//
+// Equal keys give equal signatures, so no seed separates them in a BDZ
+// hypergraph and a retry loop can only fail. BDZCore notices equal
+// signatures in the 2-core of the first failed peel; models then locate the
+// repeats here, by sorting (signature, position) records, and either
+// report them in ConstructionStats or drop them (BuildConfig::deduplicate).
+//
+// Positions are input positions of repeated keys; the first occurrence of
+// each key is kept and not reported. Repeats are judged on 128 bits: a
+// model whose signatures hold only the 64-bit preprocessed hash, where two
+// distinct keys may collide, confirms on the keys (findDuplicateKeys).
+
+namespace detail {
+
+struct SignatureRecord {
+    uint64_t hi;
+    uint64_t lo;
+    size_t position;
+
+    bool operator<(const SignatureRecord& other) const {
+        if (hi != other.hi) return hi < other.hi;
+        if (lo != other.lo) return lo < other.lo;
+        return position < other.position;
+    }
+};
+
+} // namespace detail
+
+// Positions (ascending) of records whose (hi, lo) equals an earlier one's.
+// lo may be null (64-bit signatures). Chunks are sorted on num_threads
+// threads, then merged.
+inline std::vector<size_t> findDuplicateSignatures(const uint64_t* hi, const uint64_t* lo, size_t n,
+                                                   unsigned num_threads) {
+    std::vector<detail::SignatureRecord> records(n);
+    size_t num_chunks = std::max(1u, num_threads);
+    size_t chunk = (n + num_chunks - 1) / num_chunks;
+    parallel_for(num_chunks, num_threads, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; c++) {
+            size_t begin = std::min(n, c * chunk), end = std::min(n, begin + chunk);
+            for (size_t i = begin; i < end; i++) {
+                records[i] = {hi[i], lo ? lo[i] : 0, i};
+            }
+            std::sort(records.begin() + begin, records.begin() + end);
+        }
+    }, 1);
+    for (size_t width = chunk; width < n; width *= 2) {
+        for (size_t begin = 0; begin + width < n; begin += 2 * width) {
+            std::inplace_merge(records.begin() + begin, records.begin() + begin + width,
+                               records.begin() + std::min(n, begin + 2 * width));
+        }
+    }
+
+    std::vector<size_t> repeats;
+    for (size_t i = 1; i < n; i++) {
+        if (records[i].hi == records[i - 1].hi && records[i].lo == records[i - 1].lo) {
+            repeats.push_back(records[i].position);
+        }
+    }
+    std::sort(repeats.begin(), repeats.end());
+    return repeats;
+}
+
+// Over a build's signature columns: index hash and, when stored, fingerprint
+inline std::vector<size_t> findDuplicateSignatures(const KeySignatures& sigs, unsigned num_threads) {
+    return findDuplicateSignatures(sigs.index_hashes.data(),
+                                   sigs.fingerprints.empty() ? nullptr : sigs.fingerprints.data(),
+                                   sigs.size(), num_threads);
+}
+
+// Over the keys themselves, by 128-bit MurmurHash3 signatures of their bytes
+template <typename Key>
+std::vector<size_t> findDuplicateKeys(const std::vector<Key>& keys, unsigned num_threads) {
+    std::vector<uint64_t> hi(keys.size()), lo(keys.size());
+    parallel_for(keys.size(), num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            KeyBytes bytes = key_bytes(keys[i]);
+            const char* data = reinterpret_cast<const char*>(bytes.data);
+            hi[i] = MurmurHash3::hash64_bytes(data, bytes.size, 0x243f6a8885a308d3ULL);
+            lo[i] = MurmurHash3::hash64_bytes(data, bytes.size, 0x13198a2e03707344ULL);
+        }
+    });
+    return findDuplicateSignatures(hi.data(), lo.data(), keys.size(), num_threads);
+}
+
+// Remove the entries at `positions` (ascending) from a column; no-op on an
+// empty column
+template <typename T>
+void eraseDuplicates(std::vector<T>& values, const std::vector<size_t>& positions) {
+    if (values.empty() || positions.empty()) return;
+    size_t out = 0, next = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (next < positions.size() && positions[next] == i) {
+            next++;
+            continue;
+        }
+        if (out != i) values[out] = std::move(values[i]);
+        out++;
+    }
+    values.resize(out);
+}
+
+// Record repeats in the stats and warn: the build either failed on them or
+// (dropped) ran without them
+inline void reportDuplicates(ConstructionStats& stats, const std::vector<size_t>& positions,
+                             const std::string& model, bool dropped) {
+    stats.duplicate_keys = positions.size();
+    size_t reported = std::min(positions.size(), ConstructionStats::MAX_REPORTED_DUPLICATES);
+    stats.duplicate_positions.assign(positions.begin(), positions.begin() + reported);
+    if (positions.empty()) return;
+
+    std::cerr << "Warning: " << model << ": " << positions.size() << " repeated key(s), first at input position "
+              << positions.front() << (dropped ? "; dropped\n" : "; construction stopped\n");
+}
+
+} // namespace hashing
+
+#endif // DUPLICATE_KEYS_HPP
@@ -0,0 +1,96 @@
+#ifndef FINGERPRINT_ARRAY_HPP
+#define FINGERPRINT_ARRAY_HPP
+
+#include "huge_page_allocator.hpp"
+#include "serialization.hpp"
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+namespace hashing {
+
+// Packed array of fixed-width verification fingerprints (1-64 bits each).
+// Entries are stored back to back in 64-bit words, so a 16-bit fingerprint
+// costs 16 bits/key instead of a full uint64_t.
+class FingerprintArray {
+private:
+    HugeVector<uint64_t> words;
+    size_t count = 0;
+    unsigned bits = 64;
+    uint64_t mask = ~0ULL;
+
+public:
+    FingerprintArray() = default;
+
+    void reset(size_t n, unsigned width) {
+        if (width == 0 || width > 64) {
+            throw std::invalid_argument("Fingerprint width must be between 1 and 64 bits");
+        }
+        count = n;
+        bits = width;
+        mask = (width == 64) ? ~0ULL : ((1ULL << width) - 1);
+        words.assign((n * width + 63) / 64, 0);
+    }
+
+    // Change the entry count, keeping stored entries (new ones are zero)
+    void resize(size_t n) {
+        count = n;
+        words.resize((n * bits + 63) / 64, 0);
+    }
+
+    // Truncate a full 64-bit fingerprint to the stored width
+    uint64_t truncate(uint64_t fp) const { return fp & mask; }
+
+    uint64_t get(size_t i) const {
+        size_t bit = i * bits;
+        size_t word = bit / 64;
+        unsigned offset = bit % 64;
+        uint64_t value = words[word] >> offset;
+        if (offset + bits > 64) {
+            value |= words[word + 1] << (64 - offset);
+        }
+        return value & mask;
+    }
+
+    void set(size_t i, uint64_t fp) {
+        fp &= mask;
+        size_t bit = i * bits;
+        size_t word = bit / 64;
+        unsigned offset = bit % 64;
+        words[word] = (words[word] & ~(mask << offset)) | (fp << offset);
+        if (offset + bits > 64) {
+            unsigned spill = offset + bits - 64;
+            uint64_t high_mask = (1ULL << spill) - 1;
+            words[word + 1] = (words[word + 1] & ~high_mask) | (fp >> (64 - offset));
+        }
+    }
+
+    bool matches(size_t i, uint64_t fp) const { return get(i) == truncate(fp); }
+
+    // Address of the word holding entry i (for prefetching)
+    const uint64_t* locate(size_t i) const { return &words[(i * bits) / 64]; }
+
+    size_t size() const { return count; }
+    unsigned width() const { return bits; }
+    size_t sizeInBytes() const { return words.size() * sizeof(uint64_t); }
+
+    void save(std::ostream& out) const {
+        io::write_pod<uint64_t>(out, count);
+        io::write_pod<uint32_t>(out, bits);
+        io::write_vector(out, words);
+    }
+
+    void load(std::istream& in) {
+        size_t n = io::read_pod<uint64_t>(in);
+        unsigned width = io::read_pod<uint32_t>(in);
+        reset(n, width);
+        io::read_vector(in, words);
+        if (words.size() != (n * width + 63) / 64) {
+            throw std::runtime_error("Corrupt fingerprint array");
+        }
+    }
+};
+
+} // namespace hashing
+
+#endif // FINGERPRINT_ARRAY_HPP
@@ -0,0 +1,88 @@
+#ifndef FIXED_KEY_MODELS_HPP
+#define FIXED_KEY_MODELS_HPP
+
+#include "hybrid_pipeline.hpp"
+#include "ultimate_hybrid.hpp"
+#include "adaptive_security_hybrid.hpp"
+#include "parallel_verification_hybrid.hpp"
+#include "cache_partitioned_hybrid.hpp"
+#include "ultra_low_memory_hybrid.hpp"
+#include "hybrid_crypto_perfect.hpp"
+#include <array>
+#include <cstdint>
+
+namespace hashing {
+
+// Models over integer and fixed-width binary keys.
+//
+// ID-mapping tables hold 64-bit integers or 16-byte UUIDs; formatting them
+// as strings costs an allocation per key and hashes twice the bytes. These
+// are the string pipelines with Key = uint64_t or std::array<uint8_t, N>:
+// the same stages, the same index and file layout, with kernels for the
+// key type:
+//
+//   uint64_t:                 one multiply-and-fold (KeyHash::WIDE_MULTIPLY
+//                             by default) and a bijective fingerprint, so
+//                             64-bit fingerprints verify keys exactly
+//   std::array<uint8_t, N>:   the pipeline's SipHash, unrolled for length N
+//
+// BuildConfig::key_hash overrides the preprocessing hash as for strings,
+// e.g. SIPHASH_2_4 for integer keys chosen by untrusted clients.
+
+using Uuid = std::array<uint8_t, 16>;
+
+namespace detail {
+
+// Integer keys default to the multiply-and-fold; other keys keep the
+// string pipeline's preprocessor
+template <typename Key, typename Preprocessor>
+struct fixed_key_preprocessor {
+    using type = Preprocessor;
+};
+
+template <typename Preprocessor>
+struct fixed_key_preprocessor<uint64_t, Preprocessor> {
+    using type = KeyedPreprocessor<KeyHash::WIDE_MULTIPLY>;
+};
+
+template <typename Pipeline, typename Key>
+struct with_key;
+
+template <typename Preprocessor, typename Filter, typename Index, typename Verifier, typename Key>
+struct with_key<HybridPipeline<Preprocessor, Filter, Index, Verifier>, Key> {
+    using type = HybridPipeline<typename fixed_key_preprocessor<Key, Preprocessor>::type,
+                                Filter, Index, Verifier, Key>;
+};
+
+} // namespace detail
+
+// A string pipeline's stages over keys of type Key
+template <typename Pipeline, typename Key>
+using FixedKeyPipeline = typename detail::with_key<Pipeline, Key>::type;
+
+// BDZ MPHF alone (minimal: rank directory over BDZIndex): indices in [0, n),
+// no verification
+template <typename Key>
+using FixedKeyBDZ = FixedKeyPipeline<HybridPipeline<SipHash24Preprocessor, NoFilter, BDZIndex, NoVerifier>, Key>;
+
+template <typename Key>
+using FixedKeyUltimate = FixedKeyPipeline<UltimatePipeline, Key>;
+
+template <typename Key>
+using FixedKeyAdaptive = FixedKeyPipeline<AdaptivePipeline, Key>;
+
+template <typename Key>
+using FixedKeyParallelVerification = FixedKeyPipeline<ParallelVerificationPipeline, Key>;
+
+template <typename Key>
+using FixedKeyCachePartitioned = FixedKeyPipeline<CachePartitionedPipeline, Key>;
+
+template <typename Key>
+using FixedKeyUltraLowMemory = FixedKeyPipeline<UltraLowMemoryPipeline, Key>;
+
+template <typename Key>
+using FixedKeyCryptoPerfect = FixedKeyPipeline<CryptoPerfectPipeline, Key>;
+
+} // namespace hashing
+
+#endif // FIXED_KEY_MODELS_HPP
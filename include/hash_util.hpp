@@ -0,0 +1,29 @@
+#ifndef HASH_UTIL_HPP
+#define HASH_UTIL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace hashing {
+
+inline unsigned popcount64(uint64_t x) {
+#ifdef _MSC_VER
+    return static_cast<unsigned>(__popcnt64(x));
+#else
+    return static_cast<unsigned>(__builtin_popcountll(x));
+#endif
+}
+
+// Map a 32-bit hash onto [0, range) without division (multiply-shift);
+// covers ranges up to 2^32
+inline size_t fastrange32(uint32_t h, size_t range) {
+    return static_cast<size_t>((static_cast<uint64_t>(h) * range) >> 32);
+}
+
+} // namespace hashing
+
+#endif // HASH_UTIL_HPP
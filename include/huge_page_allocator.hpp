@@ -0,0 +1,86 @@
+#ifndef HUGE_PAGE_ALLOCATOR_HPP
+#define HUGE_PAGE_ALLOCATOR_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+namespace hashing {
+
+// Page size policy for large index arrays (g tables, fingerprints, Bloom
+// words, cuckoo buckets). Random probes into tens of MB of 4 KB pages miss
+// the dTLB as well as the cache; 2 MB pages cover the same array with
+// 512x fewer TLB entries.
+//
+// The policy is process-wide and read when an array is allocated, so it
+// applies to indexes built or loaded after setHugePages(). Arrays below
+// HUGE_PAGE_SIZE always come from the ordinary heap.
+enum class HugePages {
+    OFF,          // 4 KB pages (transparent huge pages refused via madvise)
+    TRANSPARENT,  // madvise(MADV_HUGEPAGE); the kernel backs what it can
+    EXPLICIT      // MAP_HUGETLB from the reserved pool, else TRANSPARENT
+};
+
+constexpr size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+
+void setHugePages(HugePages policy);
+HugePages hugePages();
+
+// Bytes currently mapped for large arrays, and how many of them came from
+// the MAP_HUGETLB pool (the kernel does not report THP coverage per range)
+size_t hugePageMappedBytes();
+size_t hugePageExplicitBytes();
+
+namespace detail {
+// Page-aligned mapping of at least `bytes` (>= HUGE_PAGE_SIZE); throws
+// std::bad_alloc
+void* map_pages(size_t bytes);
+void unmap_pages(void* p, size_t bytes) noexcept;
+} // namespace detail
+
+// Stateless allocator: large blocks are 2 MB aligned mappings under the
+// current HugePages policy, small ones use aligned operator new
+template <typename T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    HugePageAllocator() noexcept = default;
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        size_t bytes = n * sizeof(T);
+        if (bytes >= HUGE_PAGE_SIZE) {
+            return static_cast<T*>(detail::map_pages(bytes));
+        }
+        return static_cast<T*>(::operator new(bytes, std::align_val_t(alignof(T))));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        size_t bytes = n * sizeof(T);
+        if (bytes >= HUGE_PAGE_SIZE) {
+            detail::unmap_pages(p, bytes);
+        } else {
+            ::operator delete(p, std::align_val_t(alignof(T)));
+        }
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U>&) const noexcept { return false; }
+};
+
+// Vector for index arrays that lookups probe at random
+template <typename T>
+using HugeVector = std::vector<T, HugePageAllocator<T>>;
+
+} // namespace hashing
+
+#endif // HUGE_PAGE_ALLOCATOR_HPP
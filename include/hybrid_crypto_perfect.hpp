@@ -1,27 +1,25 @@
 #ifndef HYBRID_CRYPTO_PERFECT_HPP
 #define HYBRID_CRYPTO_PERFECT_HPP
 
-#include "base_hash.hpp"
-#include "bdz_mphf.hpp"
-#include "siphash.hpp"
+#include "hybrid_pipeline.hpp"
 
 namespace hashing {
 
 // Hybrid Model 1: Cryptographic Preprocessing + Perfect Hash Lookup
-// Use SipHash to reduce keys to fingerprints, then MPHF for collision-free indexing
-class HybridCryptoPerfect : public HashModel {
-private:
-    BDZ_MPHF perfect_hash;
-    SipHash crypto_hash;
-    std::vector<uint64_t> fingerprints;  // Cryptographic fingerprints
-    
+//
+// Architecture:
+// - SipHash-2-4 preprocessing (the only pass over the key)
+// - BDZ MPHF over the SipHash values
+// - Compact verification code per slot (16 bits by default), derived from
+//   the SipHash value, so build and lookup never hash the key twice
+// - ~19 bits/key; keys outside the set pass with probability 2^-bits
+using CryptoPerfectPipeline = HybridPipeline<SipHash24Preprocessor, NoFilter, BDZIndex, SignatureCodeVerifier>;
+
+class HybridCryptoPerfect final : public CryptoPerfectPipeline {
 public:
     std::string getName() const override { 
         return "Hybrid: SipHash Preprocessing + BDZ MPHF"; 
     }
-    void build(const std::vector<std::string>& keys) override;
-    uint64_t hash(const std::string& key) const override;
-    size_t getMemoryUsage() const override;
     void printStats() const override;
 };
 
@@ -2,27 +2,83 @@
 #define HYBRID_PERFECT_VERIFY_HPP
 
 #include "base_hash.hpp"
-#include "cuckoo_perfect_hash.hpp"
-#include "blake3_hash.hpp"
+#include "cuckoo_table.hpp"
+#include "fingerprint_array.hpp"
+#include "hybrid_stages.hpp"
+#include "key_signature.hpp"
+#include "coroutine_lookup.hpp"
+#include <vector>
+#include <string>
+#include <random>
 
 namespace hashing {
 
 // Hybrid Model 2: Perfect Hash Indexing + Cryptographic Verification
-// Use perfect hash for O(1) lookup, then BLAKE3 for collision detection
-class HybridPerfectVerify : public HashModel {
-private:
-    CuckooPerfectHash perfect_hash;
-    BLAKE3Hash crypto_verifier;
-    std::vector<uint64_t> verification_codes;  // BLAKE3 checksums
-    
+//
+// Architecture:
+// - SipHash-2-4 preprocessing picks two cuckoo buckets and a 16-bit tag
+// - CuckooTable maps the key to its index in [0, n) (no keys stored)
+// - Compact BLAKE3 verification code per index (16 bits by default),
+//   checked for every tag match, so keys outside the set pass with
+//   probability ~2^-bits per matching tag. BLAKE3 runs only once a tag
+//   matches, so most keys outside the set skip it.
+//
+// Unlike the MPHF hybrids the index is mutable: the table is sized with
+// BuildConfig::table_factor slots per key (at most 95% load), and insert()
+// adds keys into that headroom. Repeated keys in a build are found on the
+// full signatures and reported, or dropped (BuildConfig::deduplicate).
+class HybridPerfectVerify final : public HashModel {
 public:
+    static constexpr unsigned DEFAULT_CODE_BITS = 16;
+    static constexpr double MAX_LOAD = 0.95;
+
     std::string getName() const override { 
         return "Hybrid: Cuckoo Perfect Index + BLAKE3 Verification"; 
     }
     void build(const std::vector<std::string>& keys) override;
+    void buildAndRelease(std::vector<std::string>&& keys) override;
     uint64_t hash(const std::string& key) const override;
     size_t getMemoryUsage() const override;
     void printStats() const override;
+    ConstructionStats getConstructionStats() const override { return construction_stats; }
+    void save(std::ostream& out) const override;
+    void load(std::istream& in) override;
+
+    // out[i] = hash(keys[i]), with the bucket loads of a whole group in flight
+    void hashBatch(const std::string* keys, size_t n, uint64_t* out) const;
+
+#ifdef HASHING_COROUTINES
+    // hash(key) for lookupInterleaved(): awaits the buckets, then the codes
+    // of tag matches (keys without a match skip the second wait)
+    LookupTask hashCoroutine(const std::string& key) const;
+#endif
+
+    // Add a key; returns its index (the existing one if already present).
+    // Presence is judged by tag and code only, so a new key that matches a
+    // stored key's tag and code (about 2^-(16 + code bits) per stored key
+    // in its two buckets) gets that key's index instead of its own.
+    // Throws std::length_error when the table has no reachable free slot.
+    uint64_t insert(const std::string& key);
+
+    size_t size() const { return num_keys; }
+    double loadFactor() const;
+
+private:
+    static constexpr int MAX_BUILD_ATTEMPTS = 20;
+    static constexpr double BUILD_GROWTH = 1.05;
+    static constexpr size_t BATCH_SIZE = 16;
+
+    SipHash24Preprocessor preprocessor;
+    CuckooTable table;
+    FingerprintArray codes;
+    size_t num_keys = 0;
+
+    ConstructionStats construction_stats;
+
+    uint64_t find(uint64_t preprocessed, uint64_t code) const;
+    uint64_t find_key(const std::string& key, uint64_t preprocessed) const;
+    KeySignatures hash_keys(const std::vector<std::string>& keys, std::mt19937_64& gen);
+    void build_from_signatures(KeySignatures& sigs);
 };
 
 } // namespace hashing
@@ -0,0 +1,388 @@
+#ifndef HYBRID_PIPELINE_HPP
+#define HYBRID_PIPELINE_HPP
+
+#include "base_hash.hpp"
+#include "hybrid_stages.hpp"
+#include "key_signature.hpp"
+#include "duplicate_keys.hpp"
+#include "key_arena.hpp"
+#include "serialization.hpp"
+#include "coroutine_lookup.hpp"
+#include <vector>
+#include <string>
+#include <random>
+#include <iostream>
+#include <algorithm>
+
+namespace hashing {
+
+// Policy-based hybrid: Preprocessor -> Filter -> Index -> Verifier
+//
+// Lookup computes the preprocessed hash once and hands it to the filter,
+// the index and the verifier; all stage calls are non-virtual and inline.
+// Build hashes every key once into KeySignatures and drives all stages
+// from them. hashBatch() runs the preprocessing for a group of keys and
+// prefetches their index words before resolving any of them. In
+// HASHING_COROUTINES builds hashCoroutine() is the same lookup as a
+// coroutine for lookupInterleaved(). The hybrid models are thin wrappers
+// that add a name, stats output and model-specific knobs. Key is
+// std::string for all of them; fixed_key_models.hpp instantiates the same
+// stages over integer and fixed-width binary keys.
+//
+// With BuildConfig::exact the build also stores the keys at their index
+// slots (KeyArena) and a lookup compares the key after the verifier, so
+// hash() is an exact membership test. A verifier without stored
+// fingerprints (RecomputeVerifier) adds nothing then and is skipped.
+//
+// Serialized payload: preprocessor, key count, index, verifier, filter,
+// key arena.
+template <typename Preprocessor, typename Filter, typename Index, typename Verifier,
+          typename Key = std::string>
+class HybridPipeline : public BasicHashModel<Key> {
+public:
+    std::string getName() const override { return "Hybrid Pipeline"; }
+
+    void build(const std::vector<Key>& keys) override {
+        std::mt19937_64 gen = build_rng();
+
+        KeySignatures sigs = hash_keys(keys, gen);
+        build_without_repeats(sigs, gen, &keys);
+        if (build_config.exact && construction_stats.success) {
+            storeKeys(keys.size(), [&keys](size_t i) -> const Key& { return keys[i]; });
+        }
+    }
+
+    void buildAndRelease(std::vector<Key>&& keys) override {
+        if (build_config.exact || !FINGERPRINT_COLUMN) {
+            // The key arena is written from the keys after the index; without
+            // fingerprints, repeats are confirmed on the keys
+            build(keys);
+            std::vector<Key>().swap(keys);
+            return;
+        }
+        std::mt19937_64 gen = build_rng();
+
+        KeySignatures sigs = hash_keys(keys, gen);
+        std::vector<Key>().swap(keys);
+        build_without_repeats(sigs, gen, nullptr);
+    }
+
+    uint64_t hash(const Key& key) const override {
+        return lookup(key, preprocess(key));
+    }
+
+    // out[i] = hash(keys[i]), with the index loads of a whole group in
+    // flight. The index resolves the group in one lookupBatch() call (SIMD
+    // where available); the filter and verifier then run per key. Key
+    // arena offsets and entries are prefetched for the group in two rounds.
+    void hashBatch(const Key* keys, size_t n, uint64_t* out) const {
+        uint64_t preprocessed[BATCH_SIZE];
+        uint64_t indices[BATCH_SIZE];
+        for (size_t begin = 0; begin < n; begin += BATCH_SIZE) {
+            size_t count = std::min(BATCH_SIZE, n - begin);
+            for (size_t i = 0; i < count; i++) {
+                preprocessed[i] = preprocess(keys[begin + i]);
+                filter.prefetch(preprocessed[i]);
+                mphf.prefetch(preprocessed[i]);
+            }
+            mphf.lookupBatch(preprocessed, count, indices);
+            for (size_t i = 0; i < count; i++) {
+                if (!filter.mayContain(preprocessed[i])) {
+                    indices[i] = Index::NOT_FOUND;
+                } else if (indices[i] != Index::NOT_FOUND) {
+                    verifier.prefetch(preprocessed[i], indices[i]);
+                    if (!key_store.empty()) prefetch_read(key_store.locate(indices[i]));
+                }
+            }
+            if (!key_store.empty()) {
+                for (size_t i = 0; i < count; i++) {
+                    if (indices[i] != Index::NOT_FOUND) prefetch_read(key_store.locateEntry(indices[i]));
+                }
+            }
+            for (size_t i = 0; i < count; i++) {
+                out[begin + i] = verified(keys[begin + i], preprocessed[i], indices[i]);
+            }
+        }
+    }
+
+#ifdef HASHING_COROUTINES
+    // hash(key), suspending after the prefetch of each dependent load
+    LookupTask hashCoroutine(const Key& key) const {
+        return lookupCoroutine(key, preprocess(key));
+    }
+#endif
+
+    uint64_t outputRange() const override { return mphf.range(); }
+
+    size_t getMemoryUsage() const override {
+        return sizeof(*this) + filter.sizeInBytes() + mphf.sizeInBytes() + verifier.sizeInBytes() +
+               key_store.sizeInBytes();
+    }
+
+    void printStats() const override {
+        std::cout << "  MPHF Space: " << mphf.sizeInBytes() << " bytes\n";
+        if (mphf.fallbackKeys() > 0) {
+            std::cout << "  2-core fallback: " << mphf.fallbackKeys() << " keys\n";
+        }
+        printKeyStoreStats();
+        if (construction_stats.success) {
+            std::cout << "  Construction attempts: " << construction_stats.attempts << "\n";
+        }
+    }
+
+    ConstructionStats getConstructionStats() const override { return construction_stats; }
+
+    void save(std::ostream& out) const override {
+        preprocessor.save(out);
+        io::write_pod<uint64_t>(out, num_keys);
+        mphf.save(out);
+        verifier.save(out);
+        filter.save(out);
+        key_store.save(out);
+    }
+
+    void load(std::istream& in) override {
+        preprocessor.load(in);
+        num_keys = io::read_pod<uint64_t>(in);
+        mphf.load(in);
+        verifier.load(in);
+        filter.load(in);
+        key_store.load(in);
+        if (!key_store.empty() && key_store.numSlots() != mphf.range()) {
+            throw std::runtime_error("Corrupt pipeline index: key arena does not match the index");
+        }
+        construction_stats = ConstructionStats();
+        construction_stats.success = true;
+    }
+
+    // Stage-level entry points, for composite models that route keys
+    // between several pipelines and hash each key once for all of them
+
+    // Draw fresh preprocessing keys (invalidates the built structure)
+    void reseed(std::mt19937_64& gen) { preprocessor.reseed(gen, build_config.key_hash); }
+
+    uint64_t preprocess(const Key& key) const { return preprocessor(key); }
+
+    uint64_t fingerprint(const Key& key) const { return verifier.fingerprint(key); }
+
+    // Remaining stages for a key whose preprocessed hash is known
+    uint64_t lookup(const Key& key, uint64_t preprocessed) const {
+        if (!filter.mayContain(preprocessed)) {
+            return UINT64_MAX;
+        }
+
+        if constexpr (Verifier::EAGER) {
+            uint64_t fp = verifier.fingerprint(key);
+            uint64_t index = mphf.lookup(preprocessed);
+            if (index == Index::NOT_FOUND || !verifier.matches(index, fp) || !stored_key_matches(key, index)) {
+                return UINT64_MAX;
+            }
+            return index;
+        } else {
+            uint64_t index = mphf.lookup(preprocessed);
+            if (index == Index::NOT_FOUND || !verify_slot(key, preprocessed, index)) {
+                return UINT64_MAX;
+            }
+            return index;
+        }
+    }
+
+#ifdef HASHING_COROUTINES
+    // lookup(key, preprocessed) as a coroutine: filter words, index lines
+    // and fingerprint are each prefetched and awaited, skipping the stages
+    // the key does not reach. Found indices are offset by `base` (lane
+    // offset in composite models).
+    LookupTask lookupCoroutine(const Key& key, uint64_t preprocessed, uint64_t base = 0) const {
+        if (filter.prefetch(preprocessed)) {
+            co_await PrefetchSuspend{};
+        }
+        if (!filter.mayContain(preprocessed)) {
+            co_return UINT64_MAX;
+        }
+
+        uint64_t fp = 0;
+        mphf.prefetch(preprocessed);
+        if constexpr (Verifier::EAGER) {
+            fp = verifier.fingerprint(key);
+        }
+        co_await PrefetchSuspend{};
+
+        uint64_t index = mphf.lookup(preprocessed);
+        if (index == Index::NOT_FOUND) {
+            co_return UINT64_MAX;
+        }
+        bool pending = verifier.prefetch(preprocessed, index);
+        if (!key_store.empty()) {
+            prefetch_read(key_store.locate(index));
+            pending = true;
+        }
+        if (pending) {
+            co_await PrefetchSuspend{};
+        }
+
+        bool valid;
+        if constexpr (Verifier::EAGER) {
+            valid = verifier.matches(index, fp) && stored_key_matches(key, index);
+        } else {
+            valid = verify_slot(key, preprocessed, index);
+        }
+        co_return valid ? base + index : UINT64_MAX;
+    }
+#endif
+
+    // Signatures under the current preprocessing keys; fingerprints are
+    // filled only if the verifier stores them
+    KeySignatures computeSignatures(const std::vector<Key>& keys) const {
+        if constexpr (FINGERPRINT_COLUMN) {
+            return compute_signatures(keys, build_config.num_threads,
+                [this](const Key& key) { return preprocess(key); },
+                [this](const Key& key) { return fingerprint(key); });
+        } else {
+            return compute_signatures(keys, build_config.num_threads,
+                [this](const Key& key) { return preprocess(key); });
+        }
+    }
+
+    // Filter, index and verifier from precomputed signatures
+    bool buildFromSignatures(const KeySignatures& sigs, std::mt19937_64& gen) {
+        construction_stats = ConstructionStats();
+        num_keys = sigs.size();
+        key_store = KeyArena();
+
+        filter.build(sigs, gen);
+
+        bool success = mphf.build(sigs.index_hashes.data(), num_keys, gen, build_config, construction_stats);
+        construction_stats.success = success;
+        if (!success && !mphf.equalSignatures()) {
+            std::cerr << "Warning: " << getName() << " MPHF construction failed after "
+                      << construction_stats.attempts << " attempts\n";
+        }
+
+        // Fingerprints at their MPHF slots
+        if constexpr (Verifier::STORES_FINGERPRINTS) {
+            unsigned bits = build_config.fingerprint_bits ? build_config.fingerprint_bits
+                                                          : Verifier::DEFAULT_BITS;
+            verifier.reset(mphf.range(), bits);
+            if (success) {
+                for (size_t i = 0; i < num_keys; i++) {
+                    uint64_t fp;
+                    if constexpr (Verifier::FROM_PREPROCESSED) {
+                        fp = Verifier::code(sigs.index_hashes[i]);
+                    } else {
+                        fp = sigs.fingerprints[i];
+                    }
+                    verifier.store(mphf.lookup(sigs.index_hashes[i]), fp);
+                }
+            }
+        }
+        return success;
+    }
+
+    // Exact mode: store key_at(i), i < n, at its index slot. Keys outside
+    // the built set are skipped; call after the stages are built.
+    template <typename KeyAt>
+    void storeKeys(size_t n, KeyAt key_at) {
+        // NOT_FOUND is past the last slot, so the arena skips those keys
+        key_store.build(mphf.range(), n,
+                        [&](size_t i) { return mphf.lookup(preprocess(key_at(i))); },
+                        key_at, build_config.num_threads);
+    }
+
+    void printKeyStoreStats() const {
+        if (key_store.empty()) return;
+        std::cout << "  Key arena (exact): " << key_store.sizeInBytes() << " bytes ("
+                  << (key_store.sizeInBytes() * 8.0 / std::max<size_t>(num_keys, 1)) << " bits/key)\n";
+    }
+
+    size_t numKeys() const { return num_keys; }
+    const Filter& filterStage() const { return filter; }
+    const Index& indexStage() const { return mphf; }
+    const Verifier& verifierStage() const { return verifier; }
+    const KeyArena& keyStore() const { return key_store; }
+
+protected:
+    using BasicHashModel<Key>::build_config;
+    using BasicHashModel<Key>::build_rng;
+
+    static constexpr size_t BATCH_SIZE = 16;
+    // Signatures carry a key fingerprint next to the preprocessed hash
+    static constexpr bool FINGERPRINT_COLUMN = Verifier::STORES_FINGERPRINTS && !Verifier::FROM_PREPROCESSED;
+
+    Preprocessor preprocessor;
+    Filter filter;
+    Index mphf;
+    Verifier verifier;
+    KeyArena key_store;  // Empty unless built with BuildConfig::exact
+    size_t num_keys = 0;
+
+    ConstructionStats construction_stats;
+
+    // Verifier check of an index lookup result
+    uint64_t verified(const Key& key, uint64_t preprocessed, uint64_t index) const {
+        if (index == Index::NOT_FOUND) {
+            return UINT64_MAX;
+        }
+        bool valid;
+        if constexpr (Verifier::EAGER) {
+            valid = verifier.matches(index, verifier.fingerprint(key)) && stored_key_matches(key, index);
+        } else {
+            valid = verify_slot(key, preprocessed, index);
+        }
+        return valid ? index : UINT64_MAX;
+    }
+
+    bool stored_key_matches(const Key& key, uint64_t index) const {
+        return key_store.empty() || key_store.matches(index, key_bytes(key));
+    }
+
+    // Lazy verifiers: the verifier's check, then the stored key. Stored
+    // fingerprints reject most absent keys before the arena is read.
+    bool verify_slot(const Key& key, uint64_t preprocessed, uint64_t index) const {
+        if (key_store.empty()) {
+            return verifier.verify(key, preprocessed, index);
+        }
+        if constexpr (Verifier::STORES_FINGERPRINTS) {
+            if (!verifier.verify(key, preprocessed, index)) return false;
+        }
+        return key_store.matches(index, key_bytes(key));
+    }
+
+    KeySignatures hash_keys(const std::vector<Key>& keys, std::mt19937_64& gen) {
+        reseed(gen);
+        return computeSignatures(keys);
+    }
+
+    // buildFromSignatures(); if the index stopped on equal signatures, the
+    // repeated keys are reported, or dropped and the stages built again.
+    // Repeats are found on (hash, fingerprint) or, without a fingerprint
+    // column, on the keys (which must then be given).
+    void build_without_repeats(KeySignatures& sigs, std::mt19937_64& gen, const std::vector<Key>* keys) {
+        if (buildFromSignatures(sigs, gen) || !mphf.equalSignatures()) {
+            return;
+        }
+        std::vector<size_t> repeats;
+        if constexpr (FINGERPRINT_COLUMN) {
+            repeats = findDuplicateSignatures(sigs, build_config.num_threads);
+        } else {
+            repeats = findDuplicateKeys(*keys, build_config.num_threads);
+        }
+        if (repeats.empty()) {
+            // Distinct keys: a preprocessing collision, not a repeat
+            std::cerr << "Warning: " << getName() << ": distinct keys share a preprocessed hash; "
+                      << "rebuild with another seed\n";
+            return;
+        }
+        size_t attempts = construction_stats.attempts;
+        if (build_config.deduplicate) {
+            eraseDuplicates(sigs.index_hashes, repeats);
+            eraseDuplicates(sigs.fingerprints, repeats);
+            buildFromSignatures(sigs, gen);
+            construction_stats.attempts += attempts;
+        }
+        reportDuplicates(construction_stats, repeats, getName(), build_config.deduplicate);
+    }
+};
+
+} // namespace hashing
+
+#endif // HYBRID_PIPELINE_HPP
@@ -0,0 +1,598 @@
+#ifndef HYBRID_STAGES_HPP
+#define HYBRID_STAGES_HPP
+
+#include "base_hash.hpp"
+#include "bdz_core.hpp"
+#include "fingerprint_array.hpp"
+#include "huge_page_allocator.hpp"
+#include "key_signature.hpp"
+#include "keyed_hash.hpp"
+#include "murmur_hash.hpp"
+#include "serialization.hpp"
+#include "verification_controller.hpp"
+#include <string>
+#include <vector>
+#include <array>
+#include <random>
+#include <cstring>
+#include <cstdint>
+
+namespace hashing {
+
+// Stage policies for HybridPipeline (see hybrid_pipeline.hpp).
+//
+// Each stage is a plain class with non-virtual inline members, so a
+// pipeline instantiation compiles down to one straight-line lookup. The
+// pipeline only relies on the members listed in each group's comment.
+
+inline uint64_t rotl64(uint64_t x, int b) { return (x << b) | (x >> (64 - b)); }
+inline uint32_t rotl32(uint32_t x, int b) { return (x << b) | (x >> (32 - b)); }
+
+inline void prefetch_read(const void* addr) {
+#ifdef _MSC_VER
+    (void)addr;
+#else
+    __builtin_prefetch(addr, 0, 1);
+#endif
+}
+
+inline void sip_round(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+    v0 += v1; v1 = rotl64(v1, 13); v1 ^= v0; v0 = rotl64(v0, 32);
+    v2 += v3; v3 = rotl64(v3, 16); v3 ^= v2;
+    v0 += v3; v3 = rotl64(v3, 21); v3 ^= v0;
+    v2 += v1; v1 = rotl64(v1, 17); v1 ^= v2; v2 = rotl64(v2, 32);
+}
+
+// SipHash-c-d with a 128-bit key
+template <int C_ROUNDS, int D_ROUNDS>
+inline uint64_t siphash(const uint8_t* in, size_t inlen, uint64_t k0, uint64_t k1) {
+    uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dULL ^ k1;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+    uint64_t v3 = 0x7465646279746573ULL ^ k1;
+    uint64_t b = ((uint64_t)inlen) << 56;
+
+    const uint8_t* end = in + inlen - (inlen % sizeof(uint64_t));
+    for (; in != end; in += 8) {
+        uint64_t m;
+        std::memcpy(&m, in, sizeof(m));
+        v3 ^= m;
+        for (int r = 0; r < C_ROUNDS; r++) sip_round(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    switch (inlen & 7) {
+        case 7: b |= ((uint64_t)in[6]) << 48; [[fallthrough]];
+        case 6: b |= ((uint64_t)in[5]) << 40; [[fallthrough]];
+        case 5: b |= ((uint64_t)in[4]) << 32; [[fallthrough]];
+        case 4: b |= ((uint64_t)in[3]) << 24; [[fallthrough]];
+        case 3: b |= ((uint64_t)in[2]) << 16; [[fallthrough]];
+        case 2: b |= ((uint64_t)in[1]) << 8; [[fallthrough]];
+        case 1: b |= ((uint64_t)in[0]); break;
+        case 0: break;
+    }
+
+    v3 ^= b;
+    for (int r = 0; r < C_ROUNDS; r++) sip_round(v0, v1, v2, v3);
+    v0 ^= b;
+    v2 ^= 0xff;
+    for (int r = 0; r < D_ROUNDS; r++) sip_round(v0, v1, v2, v3);
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+template <int C_ROUNDS, int D_ROUNDS>
+inline uint64_t siphash(const std::string& key, uint64_t k0, uint64_t k1) {
+    return siphash<C_ROUNDS, D_ROUNDS>(reinterpret_cast<const uint8_t*>(key.data()), key.size(), k0, k1);
+}
+
+// SipHash-c-d of a fixed-width key: the word loop has a constant trip
+// count and unrolls, the tail is resolved at compile time. Same value as
+// the byte version over the same N bytes.
+template <int C_ROUNDS, int D_ROUNDS, size_t N>
+inline uint64_t siphash(const std::array<uint8_t, N>& key, uint64_t k0, uint64_t k1) {
+    uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dULL ^ k1;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+    uint64_t v3 = 0x7465646279746573ULL ^ k1;
+
+    for (size_t w = 0; w < N / 8; w++) {
+        uint64_t m;
+        std::memcpy(&m, key.data() + 8 * w, sizeof(m));
+        v3 ^= m;
+        for (int r = 0; r < C_ROUNDS; r++) sip_round(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    uint64_t b = static_cast<uint64_t>(N) << 56;
+    for (size_t i = N & ~size_t(7); i < N; i++) {
+        b |= static_cast<uint64_t>(key[i]) << (8 * (i & 7));
+    }
+
+    v3 ^= b;
+    for (int r = 0; r < C_ROUNDS; r++) sip_round(v0, v1, v2, v3);
+    v0 ^= b;
+    v2 ^= 0xff;
+    for (int r = 0; r < D_ROUNDS; r++) sip_round(v0, v1, v2, v3);
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+// BLAKE3-like mixing function used for verification fingerprints. Bytes
+// are widened from Byte, so string keys keep their sign-extended values.
+template <typename Byte>
+inline uint64_t blake3_fingerprint(const Byte* data, size_t len) {
+    uint32_t state[8] = {
+        0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+        0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+    };
+
+    // Multiple rotations per byte for avalanche
+    for (size_t i = 0; i < len; i++) {
+        uint32_t c = static_cast<uint32_t>(data[i]);
+        size_t idx = i % 8;
+        state[idx] ^= c;
+        state[(idx + 1) % 8] ^= rotl32(state[idx], 7);
+        state[(idx + 2) % 8] ^= rotl32(state[idx], 13);
+        state[(idx + 3) % 8] ^= rotl32(state[idx], 16);
+    }
+
+    // Final mixing round for diffusion
+    for (int i = 0; i < 8; i++) {
+        state[i] = rotl32(state[i], 11) ^ state[(i + 1) % 8];
+    }
+
+    uint64_t result = 0;
+    for (int i = 0; i < 8; i++) {
+        result ^= static_cast<uint64_t>(state[i]) << ((i % 2) * 32);
+    }
+    return result;
+}
+
+inline uint64_t blake3_fingerprint(const std::string& key) {
+    return blake3_fingerprint(key.data(), key.size());
+}
+
+// Verification fingerprint of a key of each supported type. Integers use a
+// bijective mix, so a full 64-bit fingerprint identifies the key exactly.
+inline uint64_t key_fingerprint(const std::string& key) { return blake3_fingerprint(key); }
+
+template <size_t N>
+inline uint64_t key_fingerprint(const std::array<uint8_t, N>& key) {
+    return blake3_fingerprint(key.data(), N);
+}
+
+inline uint64_t key_fingerprint(uint64_t key) {
+    return MurmurHash3::fmix64(key ^ 0x243f6a8885a308d3ULL);
+}
+
+// ---------------------------------------------------------------------------
+// Preprocessors: keyed 64-bit hash of the key, computed once per lookup and
+// shared by the filter and index stages.
+//   reseed(gen, key_hash), operator()(key), save(out), load(in)
+// Keys are std::string, uint64_t or std::array<uint8_t, N>; the verifiers
+// below take the same key types.
+// ---------------------------------------------------------------------------
+
+// The hash is chosen at build time (BuildConfig::key_hash, DEFAULT meaning
+// the model's own) and stored with the index, so every model can be moved
+// between SipHash and the faster keyed hashes of keyed_hash.hpp.
+template <KeyHash DEFAULT_HASH>
+class KeyedPreprocessor {
+public:
+    void reseed(std::mt19937_64& gen, KeyHash requested = KeyHash::DEFAULT) {
+        kind = requested == KeyHash::DEFAULT ? DEFAULT_HASH : requested;
+        check_available(kind);
+        for (uint64_t& k : keys) {
+            k = gen();
+        }
+    }
+
+    uint64_t operator()(const std::string& key) const {
+        return hash_bytes(reinterpret_cast<const uint8_t*>(key.data()), key.size());
+    }
+
+    // Any byte range, e.g. a prefix of a key
+    uint64_t operator()(const uint8_t* data, size_t len) const { return hash_bytes(data, len); }
+
+    // Fixed-width keys: unrolled SipHash, or the byte hashes with a
+    // constant length
+    template <size_t N>
+    uint64_t operator()(const std::array<uint8_t, N>& key) const {
+        switch (kind) {
+            case KeyHash::SIPHASH_2_4:
+                return siphash<2, 4>(key, keys[0], keys[1]);
+            case KeyHash::SIPHASH_1_2:
+                return siphash<1, 2>(key, keys[0], keys[1]);
+            default:
+                return hash_bytes(key.data(), N);
+        }
+    }
+
+    // Integer keys: WIDE_MULTIPLY is a single multiply-and-fold, the other
+    // hashes see the key's 8 bytes
+    uint64_t operator()(uint64_t key) const {
+        if (kind == KeyHash::WIDE_MULTIPLY) {
+            return integer_hash(key, keys);
+        }
+        std::array<uint8_t, sizeof(key)> bytes;
+        std::memcpy(bytes.data(), &key, sizeof(key));
+        return (*this)(bytes);
+    }
+
+    KeyHash keyHash() const { return kind; }
+
+    void save(std::ostream& out) const {
+        io::write_pod(out, static_cast<uint8_t>(kind));
+        for (uint64_t k : keys) {
+            io::write_pod(out, k);
+        }
+    }
+
+    void load(std::istream& in) {
+        uint8_t stored = io::read_pod<uint8_t>(in);
+        if (stored == static_cast<uint8_t>(KeyHash::DEFAULT) ||
+            stored > static_cast<uint8_t>(KeyHash::WIDE_MULTIPLY)) {
+            throw std::runtime_error("Unknown preprocessing hash");
+        }
+        kind = static_cast<KeyHash>(stored);
+        check_available(kind);
+        for (uint64_t& k : keys) {
+            k = io::read_pod<uint64_t>(in);
+        }
+    }
+
+private:
+    KeyHash kind = DEFAULT_HASH;
+    uint64_t keys[4] = {};
+
+    uint64_t hash_bytes(const uint8_t* data, size_t len) const {
+        switch (kind) {
+            case KeyHash::SIPHASH_1_2:
+                return siphash<1, 2>(data, len, keys[0], keys[1]);
+            case KeyHash::WIDE_MULTIPLY:
+                return wide_multiply_hash(data, len, keys);
+#ifdef KEYED_HASH_AES
+            case KeyHash::AES:
+                return aes_hash(data, len, keys);
+#endif
+            default:
+                return siphash<2, 4>(data, len, keys[0], keys[1]);
+        }
+    }
+
+    static void check_available(KeyHash hash) {
+        if (hash == KeyHash::AES && !AES_HASH_AVAILABLE) {
+            throw std::runtime_error("AES preprocessing hash needs a build with AES-NI enabled");
+        }
+    }
+};
+
+using SipHash24Preprocessor = KeyedPreprocessor<KeyHash::SIPHASH_2_4>;
+using SipHash12Preprocessor = KeyedPreprocessor<KeyHash::SIPHASH_1_2>;
+
+// ---------------------------------------------------------------------------
+// Filters: early rejection of keys outside the set, on the preprocessed value.
+//   build(sigs, gen), mayContain(preprocessed), sizeInBytes(), save, load,
+//   prefetch(preprocessed) (start the loads mayContain() will make; false
+//   when it makes none)
+// ---------------------------------------------------------------------------
+
+class NoFilter {
+public:
+    void build(const KeySignatures&, std::mt19937_64&) {}
+    bool mayContain(uint64_t) const { return true; }
+    bool prefetch(uint64_t) const { return false; }
+    size_t sizeInBytes() const { return 0; }
+    void save(std::ostream&) const {}
+    void load(std::istream&) {}
+};
+
+// Three-probe Bloom filter; probes are derived from the preprocessed value
+class BloomFilter {
+public:
+    static constexpr size_t BITS_PER_KEY = 8;
+
+    void build(const KeySignatures& sigs, std::mt19937_64& gen) {
+        for (uint64_t& seed : seeds) {
+            seed = gen();
+        }
+        num_words = (sigs.size() * BITS_PER_KEY + 63) / 64;
+        words.assign(num_words, 0);
+        for (uint64_t preprocessed : sigs.index_hashes) {
+            for (uint64_t seed : seeds) {
+                uint64_t bit = (preprocessed ^ seed) % (num_words * 64);
+                words[bit / 64] |= 1ULL << (bit % 64);
+            }
+        }
+    }
+
+    bool mayContain(uint64_t preprocessed) const {
+        if (num_words == 0) return false;
+        for (uint64_t seed : seeds) {
+            uint64_t bit = (preprocessed ^ seed) % (num_words * 64);
+            if ((words[bit / 64] & (1ULL << (bit % 64))) == 0) {
+                return false;  // Definitely not present
+            }
+        }
+        return true;  // Maybe present
+    }
+
+    bool prefetch(uint64_t preprocessed) const {
+        if (num_words == 0) return false;
+        for (uint64_t seed : seeds) {
+            prefetch_read(&words[((preprocessed ^ seed) % (num_words * 64)) / 64]);
+        }
+        return true;
+    }
+
+    size_t sizeInBytes() const { return words.size() * sizeof(uint64_t); }
+
+    void save(std::ostream& out) const {
+        io::write_pod<uint64_t>(out, num_words);
+        for (uint64_t seed : seeds) {
+            io::write_pod(out, seed);
+        }
+        io::write_vector(out, words);
+    }
+
+    void load(std::istream& in) {
+        num_words = io::read_pod<uint64_t>(in);
+        for (uint64_t& seed : seeds) {
+            seed = io::read_pod<uint64_t>(in);
+        }
+        io::read_vector(in, words);
+        if (words.size() != num_words) {
+            throw std::runtime_error("Corrupt Bloom filter");
+        }
+    }
+
+private:
+    HugeVector<uint64_t> words;
+    size_t num_words = 0;
+    uint64_t seeds[3] = {0, 0, 0};
+};
+
+// ---------------------------------------------------------------------------
+// Index: perfect hash over the preprocessed values.
+//   build(hashes, n, gen, config, stats), lookup(preprocessed),
+//   lookupBatch(preprocessed, n, out), prefetch(preprocessed), numKeys(),
+//   fallbackKeys() (keys diverted from the 2-core, BuildConfig::divert_core),
+//   equalSignatures() (build failed on equal preprocessed values),
+//   range() (bound on indices of keys in the set; numKeys() when minimal),
+//   sizeInBytes(), save, load
+// ---------------------------------------------------------------------------
+
+// BDZ over the preprocessed values, with the g table in the given encoding.
+// BuildConfig::cache_local selects the BLOCKED vertex layout.
+template <BDZCore::GEncoding Encoding>
+class BasicBDZIndex {
+public:
+    static constexpr uint64_t NOT_FOUND = BDZCore::NOT_FOUND;
+    static constexpr int MAX_ATTEMPTS = 100;
+
+    // Retries only reseed the hypergraph, keys are not rehashed.
+    // BuildConfig::divert_core applies to the TWO_BIT encoding only.
+    bool build(const uint64_t* hashes, size_t n, std::mt19937_64& gen, const BuildConfig& config,
+               ConstructionStats& stats) {
+        BDZCore::Layout layout = config.cache_local ? BDZCore::Layout::BLOCKED : BDZCore::Layout::UNIFORM;
+        bool divert = config.divert_core && Encoding == BDZCore::GEncoding::TWO_BIT;
+        for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+            stats.attempts++;
+            if (core.build(hashes, n, gen(), config.table_factor, Encoding, layout, divert)) {
+                stats.fallback_keys += core.fallbackKeys();
+                return true;
+            }
+            if (core.equalSignatures()) {
+                return false;  // Repeated keys: no seed helps
+            }
+        }
+        return false;
+    }
+
+    uint64_t lookup(uint64_t preprocessed) const { return core.lookup(preprocessed); }
+    void lookupBatch(const uint64_t* preprocessed, size_t n, uint64_t* out) const {
+        core.lookupBatch(preprocessed, n, out);
+    }
+    void prefetch(uint64_t preprocessed) const { core.prefetch(preprocessed); }
+
+    size_t numKeys() const { return core.numKeys(); }
+    size_t fallbackKeys() const { return core.fallbackKeys(); }
+    bool equalSignatures() const { return core.equalSignatures(); }
+    size_t range() const { return core.range(); }
+    size_t tableSize() const { return core.tableSize(); }
+    size_t sizeInBytes() const { return core.sizeInBytes(); }
+    void save(std::ostream& out) const { core.save(out); }
+
+    void load(std::istream& in) {
+        core.load(in);
+        if (core.encoding() != Encoding) {
+            throw std::runtime_error("BDZ index has the wrong g encoding");
+        }
+    }
+
+private:
+    BDZCore core;
+};
+
+// Minimal: 2 bits per vertex plus rank directory, indices in [0, n)
+using BDZIndex = BasicBDZIndex<BDZCore::GEncoding::TWO_BIT>;
+
+// Perfect: 1.6 bits per vertex, indices in [0, ~1.23n); for pipelines that
+// store nothing per index
+using TernaryBDZIndex = BasicBDZIndex<BDZCore::GEncoding::TERNARY>;
+
+// ---------------------------------------------------------------------------
+// Verifiers: reject keys outside the set that the index maps to some slot.
+//   STORES_FINGERPRINTS: pipeline calls reset(n, bits) / store(index, fp) at
+//                        build time, with fp = fingerprint(key) per key and
+//                        bits = DEFAULT_BITS unless BuildConfig sets a width
+//   FROM_PREPROCESSED:   fp = code(preprocessed) instead, so the build makes
+//                        no second pass over the key strings
+//   EAGER:               pipeline computes fingerprint(key) before the index
+//                        lookup and checks matches(index, fp); otherwise it
+//                        calls verify(key, preprocessed, index) afterwards
+//   prefetch(preprocessed, index) (start the loads the check will make;
+//   false when it makes none), sizeInBytes(), save, load
+// ---------------------------------------------------------------------------
+
+class NoVerifier {
+public:
+    static constexpr bool STORES_FINGERPRINTS = false;
+    static constexpr bool FROM_PREPROCESSED = false;
+    static constexpr bool EAGER = false;
+
+    template <typename Key>
+    bool verify(const Key&, uint64_t, uint64_t) const { return true; }
+    bool prefetch(uint64_t, uint64_t) const { return false; }
+    size_t sizeInBytes() const { return 0; }
+    void save(std::ostream&) const {}
+    void load(std::istream&) {}
+};
+
+// Recomputes the fingerprint on every lookup without storing any; models the
+// verification cost of a zero-storage design
+class RecomputeVerifier : public NoVerifier {
+public:
+    template <typename Key>
+    bool verify(const Key& key, uint64_t, uint64_t) const {
+        uint64_t verification = key_fingerprint(key);
+        (void)verification;
+        return true;
+    }
+};
+
+// Stored fingerprint per slot, checked on every lookup
+class FingerprintVerifier {
+public:
+    static constexpr bool STORES_FINGERPRINTS = true;
+    static constexpr bool FROM_PREPROCESSED = false;
+    static constexpr bool EAGER = false;
+    static constexpr unsigned DEFAULT_BITS = 64;
+
+    template <typename Key>
+    uint64_t fingerprint(const Key& key) const { return key_fingerprint(key); }
+
+    void reset(size_t n, unsigned bits) { table.reset(n, bits); }
+    void store(uint64_t index, uint64_t fp) { table.set(index, fp); }
+    bool matches(uint64_t index, uint64_t fp) const { return table.matches(index, fp); }
+
+    template <typename Key>
+    bool verify(const Key& key, uint64_t, uint64_t index) const {
+        // Fingerprint load overlaps with hashing the key
+        prefetch_read(table.locate(index));
+        return matches(index, fingerprint(key));
+    }
+
+    bool prefetch(uint64_t, uint64_t index) const {
+        prefetch_read(table.locate(index));
+        return true;
+    }
+
+    const FingerprintArray& fingerprints() const { return table; }
+    size_t sizeInBytes() const { return table.sizeInBytes(); }
+    void save(std::ostream& out) const { table.save(out); }
+    void load(std::istream& in) { table.load(in); }
+
+protected:
+    FingerprintArray table;
+};
+
+// Fingerprint computed before the index lookup, so hashing runs while the
+// g-table loads are in flight
+class EagerFingerprintVerifier : public FingerprintVerifier {
+public:
+    static constexpr bool EAGER = true;
+};
+
+// Verifies a share of lookups chosen by the low bits of the preprocessed
+// hash. A fixed security level sets the share:
+//   0-1: none, 2-4: 1/16, 5-7: all
+// setAdaptive() lets a VerificationController move it between bounds from
+// the failed checks it observes; setSecurityLevel() fixes it again.
+class SampledFingerprintVerifier : public FingerprintVerifier {
+public:
+    SampledFingerprintVerifier() { setSecurityLevel(4); }
+
+    void setSecurityLevel(uint8_t level) {
+        security_level = level & 0x07;
+        controller.setFixed(security_level >= 5 ? 0 : security_level <= 1 ? VerificationController::NEVER : 4);
+    }
+    uint8_t securityLevel() const { return security_level; }
+
+    void setAdaptive(const AdaptiveVerificationConfig& config) { controller.setAdaptive(config); }
+    const VerificationController& rateController() const { return controller; }
+
+    bool shouldVerify(uint64_t preprocessed) const { return controller.sampled(preprocessed); }
+
+    template <typename Key>
+    bool verify(const Key& key, uint64_t preprocessed, uint64_t index) const {
+        bool checked = shouldVerify(preprocessed);
+        bool passed = !checked || matches(index, fingerprint(key));
+        controller.record(checked, passed);
+        return passed;
+    }
+
+    bool prefetch(uint64_t preprocessed, uint64_t index) const {
+        return shouldVerify(preprocessed) && FingerprintVerifier::prefetch(preprocessed, index);
+    }
+
+    void save(std::ostream& out) const {
+        table.save(out);
+        io::write_pod(out, security_level);
+        controller.save(out);
+    }
+
+    void load(std::istream& in) {
+        table.load(in);
+        setSecurityLevel(io::read_pod<uint8_t>(in));
+        controller.load(in);
+    }
+
+private:
+    uint8_t security_level = 4;
+    VerificationController controller;
+};
+
+// Compact code per slot derived from the preprocessed hash: no second hash
+// of the key at build or lookup time. A key outside the set passes only if
+// its code collides with the slot's (2^-bits), since the keyed
+// preprocessing already separates it from the member at that slot.
+class SignatureCodeVerifier {
+public:
+    static constexpr bool STORES_FINGERPRINTS = true;
+    static constexpr bool FROM_PREPROCESSED = true;
+    static constexpr bool EAGER = false;
+    static constexpr unsigned DEFAULT_BITS = 16;
+
+    // Remixed so the code bits are independent of the index's hash bits
+    static uint64_t code(uint64_t preprocessed) {
+        return MurmurHash3::fmix64(preprocessed ^ 0xC2B2AE3D27D4EB4FULL);
+    }
+
+    void reset(size_t n, unsigned bits) { table.reset(n, bits); }
+    void store(uint64_t index, uint64_t fp) { table.set(index, fp); }
+    bool matches(uint64_t index, uint64_t fp) const { return table.matches(index, fp); }
+
+    template <typename Key>
+    bool verify(const Key&, uint64_t preprocessed, uint64_t index) const {
+        return matches(index, code(preprocessed));
+    }
+
+    bool prefetch(uint64_t, uint64_t index) const {
+        prefetch_read(table.locate(index));
+        return true;
+    }
+
+    const FingerprintArray& fingerprints() const { return table; }
+    size_t sizeInBytes() const { return table.sizeInBytes(); }
+    void save(std::ostream& out) const { table.save(out); }
+    void load(std::istream& in) { table.load(in); }
+
+private:
+    FingerprintArray table;
+};
+
+} // namespace hashing
+
+#endif // HYBRID_STAGES_HPP
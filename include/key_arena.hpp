@@ -0,0 +1,172 @@
+#ifndef KEY_ARENA_HPP
+#define KEY_ARENA_HPP
+
+#include "fingerprint_array.hpp"
+#include "huge_page_allocator.hpp"
+#include "parallel.hpp"
+#include "serialization.hpp"
+#include <vector>
+#include <string>
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+
+namespace hashing {
+
+// Byte view of a key, as stored in a KeyArena
+struct KeyBytes {
+    const uint8_t* data;
+    size_t size;
+};
+
+inline KeyBytes key_bytes(const std::string& key) {
+    return {reinterpret_cast<const uint8_t*>(key.data()), key.size()};
+}
+
+template <size_t N>
+inline KeyBytes key_bytes(const std::array<uint8_t, N>& key) {
+    return {key.data(), N};
+}
+
+// Host byte order, like the rest of the index file
+inline KeyBytes key_bytes(const uint64_t& key) {
+    return {reinterpret_cast<const uint8_t*>(&key), sizeof(key)};
+}
+
+// The keys themselves, stored by index slot, for exact membership checks.
+//
+// Slots are grouped in buckets of BUCKET_SIZE. The first key stored in a
+// bucket is written whole; every other key is front coded against it: the
+// shared prefix length as a LEB128 varint, then the rest of the key.
+// Entries lie back to back in slot order, and a packed offsets array with
+// num_slots + 1 entries gives each slot's entry, so the suffix length is
+// implied. An empty slot has an empty entry.
+//
+// matches(slot, key) reads the slot's offsets and the bucket's bytes; the
+// head key sits at the start of the same bucket, usually one or two cache
+// lines from the entry. Keys in MPHF order share only the prefixes common to
+// the whole set, such as a scheme, a host or a table prefix, so that is the
+// part front coding saves.
+class KeyArena {
+public:
+    static constexpr size_t BUCKET_SIZE = 16;
+
+    // Stores key_at(i) at slot_of(i) for i < n; slot_of returns num_slots or
+    // more for keys not to store. When several keys share a slot, the first
+    // is kept.
+    template <typename SlotOf, typename KeyAt>
+    void build(size_t num_slots, size_t n, SlotOf slot_of, KeyAt key_at, unsigned num_threads) {
+        std::vector<uint64_t> slots(n);
+        parallel_for(n, num_threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                slots[i] = slot_of(i);
+            }
+        });
+        const size_t EMPTY = SIZE_MAX;
+        std::vector<size_t> owner(num_slots, EMPTY);
+        for (size_t i = 0; i < n; i++) {
+            if (slots[i] < num_slots && owner[slots[i]] == EMPTY) owner[slots[i]] = i;
+        }
+        std::vector<uint64_t>().swap(slots);
+
+        bytes.clear();
+        std::vector<uint64_t> starts(num_slots + 1);
+        std::string head;
+        for (size_t slot = 0; slot < num_slots; slot++) {
+            if (slot % BUCKET_SIZE == 0) head.clear();
+            starts[slot] = bytes.size();
+            if (owner[slot] == EMPTY) continue;
+
+            KeyBytes key = key_bytes(key_at(owner[slot]));
+            size_t shared = 0;
+            if (bytes.size() == starts[slot - slot % BUCKET_SIZE]) {
+                head.assign(reinterpret_cast<const char*>(key.data), key.size);  // Bucket's first key
+            } else {
+                size_t limit = std::min(head.size(), key.size);
+                while (shared < limit && static_cast<uint8_t>(head[shared]) == key.data[shared]) shared++;
+            }
+            write_varint(shared);
+            bytes.insert(bytes.end(), key.data + shared, key.data + key.size);
+        }
+        starts[num_slots] = bytes.size();
+
+        offsets.reset(num_slots + 1, bit_width(bytes.size()));
+        for (size_t slot = 0; slot <= num_slots; slot++) {
+            offsets.set(slot, starts[slot]);
+        }
+    }
+
+    bool empty() const { return offsets.size() == 0; }
+    size_t numSlots() const { return empty() ? 0 : offsets.size() - 1; }
+
+    // Whether the key stored at slot equals key
+    bool matches(uint64_t slot, KeyBytes key) const {
+        uint64_t begin = offsets.get(slot), end = offsets.get(slot + 1);
+        if (begin == end) return false;
+
+        const uint8_t* p = bytes.data() + begin;
+        uint64_t shared = read_varint(p);
+        uint64_t suffix = static_cast<uint64_t>(bytes.data() + end - p);
+        if (shared + suffix != key.size || std::memcmp(p, key.data + shared, suffix) != 0) {
+            return false;
+        }
+        if (shared == 0) return true;
+
+        // Prefix from the bucket's head entry (shared length 0, one byte)
+        uint64_t head = offsets.get(slot - slot % BUCKET_SIZE) + 1;
+        return head + shared <= begin && std::memcmp(bytes.data() + head, key.data, shared) == 0;
+    }
+
+    // Addresses matches(slot, ...) reads, for prefetching: the offsets word,
+    // then (once that is loaded) the entry
+    const uint64_t* locate(uint64_t slot) const { return offsets.locate(slot); }
+    const uint8_t* locateEntry(uint64_t slot) const { return bytes.data() + offsets.get(slot); }
+
+    size_t sizeInBytes() const { return offsets.sizeInBytes() + bytes.size(); }
+
+    void save(std::ostream& out) const {
+        offsets.save(out);
+        io::write_vector(out, bytes);
+    }
+
+    void load(std::istream& in) {
+        offsets.load(in);
+        io::read_vector(in, bytes);
+        if (!empty() && offsets.get(numSlots()) != bytes.size()) {
+            throw std::runtime_error("Corrupt key arena");
+        }
+    }
+
+private:
+    FingerprintArray offsets;  // Entry start per slot, plus the end
+    HugeVector<uint8_t> bytes;
+
+    static unsigned bit_width(uint64_t x) {
+        unsigned bits = 1;
+        while (bits < 64 && (x >> bits) != 0) bits++;
+        return bits;
+    }
+
+    void write_varint(uint64_t value) {
+        while (value >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    static uint64_t read_varint(const uint8_t*& p) {
+        uint64_t value = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            uint8_t byte = *p++;
+            value |= uint64_t(byte & 0x7F) << shift;
+            if (byte < 0x80 || shift >= 63) return value;
+        }
+    }
+};
+
+} // namespace hashing
+
+#endif // KEY_ARENA_HPP
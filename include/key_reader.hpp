@@ -0,0 +1,43 @@
+#ifndef KEY_READER_HPP
+#define KEY_READER_HPP
+
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace hashing {
+
+// Streams keys from a file or stdin for offline index builds.
+//
+// Formats:
+//   LINES           - one key per line ('\n' or "\r\n"), empty lines skipped
+//   LENGTH_PREFIXED - 32-bit little-endian length followed by the key bytes
+//                     (binary-safe, keys may contain newlines)
+class KeyReader {
+public:
+    enum class Format {
+        LINES,
+        LENGTH_PREFIXED
+    };
+
+    KeyReader(std::istream& input, Format format);
+
+    // Read the next key; returns false at end of input
+    bool next(std::string& key);
+
+    // Read every remaining key
+    std::vector<std::string> readAll();
+
+    size_t keysRead() const { return keys_read; }
+    size_t bytesRead() const { return bytes_read; }
+
+private:
+    std::istream& in;
+    Format fmt;
+    size_t keys_read = 0;
+    size_t bytes_read = 0;
+};
+
+} // namespace hashing
+
+#endif // KEY_READER_HPP
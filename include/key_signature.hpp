@@ -0,0 +1,56 @@
+#ifndef KEY_SIGNATURE_HPP
+#define KEY_SIGNATURE_HPP
+
+#include "parallel.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace hashing {
+
+// Per-key signature records, computed in one parallel pass over the keys.
+//
+// Builds drive MPHF construction, filter insertion, fingerprint storage and
+// quality statistics from these arrays instead of rehashing every key at
+// each stage, and can release the strings before peeling starts. Stored as
+// two columns so the MPHF input is a contiguous uint64_t array.
+struct KeySignatures {
+    std::vector<uint64_t> index_hashes;  // Keyed preprocessing output (MPHF input)
+    std::vector<uint64_t> fingerprints;  // Verification hash (empty if unused)
+
+    size_t size() const { return index_hashes.size(); }
+};
+
+// Signatures with index hashes only (Key: std::string or a fixed-width key)
+template <typename Key, typename IndexHash>
+KeySignatures compute_signatures(const std::vector<Key>& keys, unsigned num_threads,
+                                 IndexHash index_hash) {
+    KeySignatures sigs;
+    sigs.index_hashes.resize(keys.size());
+    parallel_for(keys.size(), num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            sigs.index_hashes[i] = index_hash(keys[i]);
+        }
+    });
+    return sigs;
+}
+
+// Signatures with index hashes and verification fingerprints
+template <typename Key, typename IndexHash, typename FingerprintHash>
+KeySignatures compute_signatures(const std::vector<Key>& keys, unsigned num_threads,
+                                 IndexHash index_hash, FingerprintHash fingerprint_hash) {
+    KeySignatures sigs;
+    sigs.index_hashes.resize(keys.size());
+    sigs.fingerprints.resize(keys.size());
+    parallel_for(keys.size(), num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            sigs.index_hashes[i] = index_hash(keys[i]);
+            sigs.fingerprints[i] = fingerprint_hash(keys[i]);
+        }
+    });
+    return sigs;
+}
+
+} // namespace hashing
+
+#endif // KEY_SIGNATURE_HPP
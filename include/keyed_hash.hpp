@@ -0,0 +1,186 @@
+#ifndef KEYED_HASH_HPP
+#define KEYED_HASH_HPP
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__AES__) && defined(__SSE2__)
+    #include <immintrin.h>
+    #define KEYED_HASH_AES 1
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__SIZEOF_INT128__)
+    #include <intrin.h>
+#endif
+
+namespace hashing {
+
+// Keyed 64-bit string hashes for the preprocessing stage, besides SipHash
+// (hybrid_stages.hpp). All take a 256-bit key drawn at build time.
+//
+//   aes_hash:            two AES rounds per 16-byte block plus three
+//                        finalization rounds (AES-NI builds only)
+//   wide_multiply_hash:  64x64->128 multiply-and-fold of key words, in the
+//                        style of wyhash; fastest on short keys
+//   integer_hash:        one multiply-and-fold of a 64-bit integer key
+//
+// The byte versions inline into callers with a constant length (the
+// fixed-width keys of fixed_key_models.hpp), which drops the length
+// branches.
+//
+// Neither is a proven PRF like SipHash: resistance to hash flooding rests
+// on the secrecy of the build key, as with aHash or wyhash's secret.
+
+namespace detail {
+
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 1-3 bytes: first, middle and last
+inline uint64_t read_small(const uint8_t* p, size_t len) {
+    return (uint64_t(p[0]) << 16) | (uint64_t(p[len >> 1]) << 8) | p[len - 1];
+}
+
+inline void mul128(uint64_t a, uint64_t b, uint64_t& lo, uint64_t& hi) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    lo = static_cast<uint64_t>(r);
+    hi = static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    lo = _umul128(a, b, &hi);
+#else
+    uint64_t a_lo = a & 0xFFFFFFFFULL, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFFULL, b_hi = b >> 32;
+    uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+    uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFULL) + (hl & 0xFFFFFFFFULL);
+    lo = (mid << 32) | (ll & 0xFFFFFFFFULL);
+    hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+inline uint64_t mul_fold(uint64_t a, uint64_t b) {
+    uint64_t lo, hi;
+    mul128(a, b, lo, hi);
+    return lo ^ hi;
+}
+
+} // namespace detail
+
+inline uint64_t wide_multiply_hash(const uint8_t* p, size_t len, const uint64_t secret[4]) {
+    uint64_t seed = secret[0] ^ detail::mul_fold(secret[0] ^ secret[1], secret[2]);
+
+    uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            // Four overlapping 4-byte reads cover any 4-16 byte key
+            size_t step = (len >> 3) << 2;
+            a = (detail::read32(p) << 32) | detail::read32(p + step);
+            b = (detail::read32(p + len - 4) << 32) | detail::read32(p + len - 4 - step);
+        } else if (len > 0) {
+            a = detail::read_small(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t remaining = len;
+        if (remaining > 48) {
+            // Three independent multiply chains per 48 bytes
+            uint64_t lane1 = seed, lane2 = seed;
+            do {
+                seed = detail::mul_fold(detail::read64(p) ^ secret[1], detail::read64(p + 8) ^ seed);
+                lane1 = detail::mul_fold(detail::read64(p + 16) ^ secret[2], detail::read64(p + 24) ^ lane1);
+                lane2 = detail::mul_fold(detail::read64(p + 32) ^ secret[3], detail::read64(p + 40) ^ lane2);
+                p += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= lane1 ^ lane2;
+        }
+        while (remaining > 16) {
+            seed = detail::mul_fold(detail::read64(p) ^ secret[1], detail::read64(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        // Last 16 bytes, overlapping the previous block if needed
+        a = detail::read64(p + remaining - 16);
+        b = detail::read64(p + remaining - 8);
+    }
+
+    uint64_t lo, hi;
+    detail::mul128(a ^ secret[1], b ^ seed, lo, hi);
+    return detail::mul_fold(lo ^ secret[0] ^ len, hi ^ secret[1]);
+}
+
+inline uint64_t wide_multiply_hash(const std::string& key, const uint64_t secret[4]) {
+    return wide_multiply_hash(reinterpret_cast<const uint8_t*>(key.data()), key.size(), secret);
+}
+
+inline uint64_t integer_hash(uint64_t key, const uint64_t secret[4]) {
+    return detail::mul_fold(key ^ secret[0], secret[1] | 1);
+}
+
+#ifdef KEYED_HASH_AES
+
+constexpr bool AES_HASH_AVAILABLE = true;
+
+inline uint64_t aes_hash(const uint8_t* p, size_t len, const uint64_t secret[4]) {
+    const __m128i key_a = _mm_set_epi64x(static_cast<long long>(secret[1]), static_cast<long long>(secret[0]));
+    const __m128i key_b = _mm_set_epi64x(static_cast<long long>(secret[3]), static_cast<long long>(secret[2]));
+
+    // The length enters the state first, so the overlapping reads below
+    // cannot make keys of different lengths collide
+    __m128i state = _mm_xor_si128(key_a, _mm_set_epi64x(0, static_cast<long long>(len)));
+    auto absorb = [&](__m128i block) {
+        state = _mm_aesenc_si128(_mm_aesenc_si128(_mm_xor_si128(state, block), key_b), key_a);
+    };
+
+    if (len > 16) {
+        const uint8_t* last = p + len - 16;
+        for (; p < last; p += 16) {
+            absorb(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        }
+        absorb(_mm_loadu_si128(reinterpret_cast<const __m128i*>(last)));
+    } else if (len >= 8) {
+        absorb(_mm_set_epi64x(static_cast<long long>(detail::read64(p + len - 8)),
+                              static_cast<long long>(detail::read64(p))));
+    } else if (len >= 4) {
+        absorb(_mm_set_epi64x(static_cast<long long>(detail::read32(p + len - 4)),
+                              static_cast<long long>(detail::read32(p))));
+    } else if (len > 0) {
+        absorb(_mm_set_epi64x(0, static_cast<long long>(detail::read_small(p, len))));
+    } else {
+        absorb(_mm_setzero_si128());
+    }
+
+    // Three more rounds: every output bit depends on every state byte
+    state = _mm_aesenc_si128(state, key_b);
+    state = _mm_aesenc_si128(state, key_a);
+    state = _mm_aesenclast_si128(state, key_b);
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(state)) ^
+           static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(state, state)));
+}
+
+inline uint64_t aes_hash(const std::string& key, const uint64_t secret[4]) {
+    return aes_hash(reinterpret_cast<const uint8_t*>(key.data()), key.size(), secret);
+}
+
+#else
+
+constexpr bool AES_HASH_AVAILABLE = false;
+
+#endif // KEYED_HASH_AES
+
+} // namespace hashing
+
+#endif // KEYED_HASH_HPP
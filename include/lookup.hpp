@@ -0,0 +1,95 @@
+#ifndef LOOKUP_HPP
+#define LOOKUP_HPP
+
+#include "base_hash.hpp"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cassert>
+#include <cstdint>
+#include <typeinfo>
+#include <type_traits>
+
+namespace hashing {
+
+// Statically dispatched lookups for callers that know the concrete model.
+//
+// HashModel::hash() is virtual, which costs an indirect call per key and
+// keeps the compiler from inlining the lookup into the caller's loop. These
+// helpers call Model::hash() by qualified name, so it binds at compile time
+// and the whole lookup path inlines into the loop. Model must be the
+// object's dynamic type (the batch helpers assert this in debug builds).
+// Instantiated with HashModel itself they fall back to virtual dispatch.
+//
+// Models with a hashBatch(keys, n, out) member (the pipeline hybrids,
+// HybridPerfectVerify, MonotoneMPHF) overlap the memory accesses of several
+// keys; the batch helpers use it when present.
+
+namespace detail {
+
+template <typename Model, typename = void>
+struct has_hash_batch : std::false_type {};
+
+template <typename Model>
+struct has_hash_batch<Model, std::void_t<decltype(std::declval<const Model&>().hashBatch(
+    std::declval<const std::string*>(), size_t(0), std::declval<uint64_t*>()))>> : std::true_type {};
+
+constexpr size_t CHECKSUM_BATCH = 64;
+
+} // namespace detail
+
+template <typename Model>
+inline uint64_t lookup(const Model& model, const std::string& key) {
+    static_assert(std::is_base_of<HashModel, Model>::value, "Model must derive from HashModel");
+    if constexpr (std::is_abstract<Model>::value) {
+        return model.hash(key);
+    } else {
+        return model.Model::hash(key);
+    }
+}
+
+// out[i] = hash(keys[i])
+template <typename Model>
+void lookupBatch(const Model& model, const std::string* keys, size_t n, uint64_t* out) {
+    assert(std::is_abstract<Model>::value || typeid(model) == typeid(Model));
+    if constexpr (detail::has_hash_batch<Model>::value) {
+        model.hashBatch(keys, n, out);
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = lookup(model, keys[i]);
+        }
+    }
+}
+
+// XOR of hash(keys[i]) over the range. Benchmarks use it to keep every
+// lookup live without a volatile store per key.
+template <typename Model>
+uint64_t lookupChecksum(const Model& model, const std::string* keys, size_t n) {
+    assert(std::is_abstract<Model>::value || typeid(model) == typeid(Model));
+    uint64_t checksum = 0;
+    if constexpr (detail::has_hash_batch<Model>::value) {
+        uint64_t out[detail::CHECKSUM_BATCH];
+        for (size_t begin = 0; begin < n; begin += detail::CHECKSUM_BATCH) {
+            size_t count = std::min(detail::CHECKSUM_BATCH, n - begin);
+            model.hashBatch(keys + begin, count, out);
+            for (size_t i = 0; i < count; i++) {
+                checksum ^= out[i];
+            }
+        }
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            checksum ^= lookup(model, keys[i]);
+        }
+    }
+    return checksum;
+}
+
+template <typename Model>
+uint64_t lookupChecksum(const Model& model, const std::vector<std::string>& keys) {
+    return lookupChecksum(model, keys.data(), keys.size());
+}
+
+} // namespace hashing
+
+#endif // LOOKUP_HPP
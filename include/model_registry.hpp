@@ -0,0 +1,25 @@
+#ifndef MODEL_REGISTRY_HPP
+#define MODEL_REGISTRY_HPP
+
+#include "base_hash.hpp"
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace hashing {
+
+// Short identifiers for the serializable models ("bdz", "ultimate", ...),
+// used by command-line tools and stored in index file headers.
+std::vector<std::string> availableModels();
+
+// Create an empty model by identifier; throws std::invalid_argument if unknown
+std::unique_ptr<HashModel> createModel(const std::string& id);
+
+// Index file = header (magic, format version, model id) + model payload
+void saveIndex(const std::string& id, const HashModel& model, std::ostream& out);
+std::unique_ptr<HashModel> loadIndex(std::istream& in, std::string* id = nullptr);
+
+} // namespace hashing
+
+#endif // MODEL_REGISTRY_HPP
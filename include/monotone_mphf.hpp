@@ -0,0 +1,79 @@
+#ifndef MONOTONE_MPHF_HPP
+#define MONOTONE_MPHF_HPP
+
+#include "base_hash.hpp"
+#include "bdz_core.hpp"
+#include "fingerprint_array.hpp"
+#include "hybrid_stages.hpp"
+#include <vector>
+#include <string>
+#include <random>
+
+namespace hashing {
+
+// Monotone minimal perfect hash: hash(key) is the key's rank in sorted
+// (bytewise lexicographic) order, so a sorted dictionary needs no separate
+// rank array next to an MPHF.
+//
+// Bucketed longest common prefix (Belazzougui, Boldi, Pagh, Vigna 2009):
+// - Keys are read as bit strings with a 1 bit before every byte and a 0
+//   bit at the end. This keeps the byte order and makes the set prefix
+//   free, so no key is a prefix of another key's encoding.
+// - The sorted keys are cut into buckets of 2^b consecutive keys. The LCP of
+//   a bucket's first and last key splits that bucket's keys between its 0
+//   and 1 subtrees, which no other (contiguous) bucket can do, so bucket
+//   LCPs are distinct.
+// - Function 1 (BDZ over keys + packed array): key -> (LCP length of its
+//   bucket, offset in the bucket)
+// - Function 2 (BDZ over bucket LCPs + packed array): LCP -> bucket
+//
+// Lookup: rank = bucket(prefix of the key) * 2^b + offset. About
+// 3 + log2(max LCP) + b + (3 + log2 n) / 2^b bits per key, with b near
+// log2(ln 2 * log2 n). Keys outside the set map to an arbitrary value or
+// UINT64_MAX. build() sorts unsorted input; ranks then follow sorted order.
+// Repeated keys fail the build, or with BuildConfig::deduplicate are ranked
+// once.
+class MonotoneMPHF final : public HashModel {
+public:
+    static constexpr int MAX_ATTEMPTS = 100;
+
+    std::string getName() const override { return "Monotone MPHF (Bucketed LCP)"; }
+    void build(const std::vector<std::string>& keys) override;
+    uint64_t hash(const std::string& key) const override;
+    size_t getMemoryUsage() const override;
+    void printStats() const override;
+    ConstructionStats getConstructionStats() const override { return construction_stats; }
+    void save(std::ostream& out) const override;
+    void load(std::istream& in) override;
+
+    // out[i] = hash(keys[i]); each of the four dependent loads (key index,
+    // key value, bucket index, bucket value) is issued for a whole group
+    void hashBatch(const std::string* keys, size_t n, uint64_t* out) const;
+
+    size_t numKeys() const { return num_keys; }
+    size_t bucketSize() const { return size_t(1) << bucket_bits; }
+
+private:
+    static constexpr size_t BATCH_SIZE = 16;
+
+    SipHash24Preprocessor key_hasher;     // Function 1 input
+    SipHash24Preprocessor prefix_hasher;  // Function 2 input
+    BDZCore key_index;
+    BDZCore bucket_index;
+    FingerprintArray key_values;     // (LCP length << bucket_bits) | offset
+    FingerprintArray bucket_values;  // Bucket number
+    unsigned bucket_bits = 0;
+    size_t num_keys = 0;
+
+    ConstructionStats construction_stats;
+
+    uint64_t prefix_signature(const std::string& key, uint64_t lcp_bits) const;
+    uint64_t rank(uint64_t key_value, uint64_t bucket_slot) const {
+        return (bucket_values.get(bucket_slot) << bucket_bits) | (key_value & (bucketSize() - 1));
+    }
+    bool build_index(BDZCore& index, const std::vector<uint64_t>& signatures, std::mt19937_64& gen);
+};
+
+} // namespace hashing
+
+#endif // MONOTONE_MPHF_HPP
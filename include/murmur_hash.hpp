@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <string_view>
 
 namespace hashing {
 
@@ -14,13 +15,17 @@ class MurmurHash3 {
 public:
     // Compute 64-bit hash with a given seed
     static uint64_t hash64(const std::string& key, uint64_t seed = 0) {
+        return hash64_bytes(key.data(), key.length(), seed);
+    }
+
+    static uint64_t hash64_bytes(const char* key, size_t len, uint64_t seed = 0) {
         const uint64_t m = 0xc6a4a7935bd1e995ULL;
         const int r = 47;
 
-        uint64_t h = seed ^ (key.length() * m);
+        uint64_t h = seed ^ (len * m);
 
-        const uint64_t* data = reinterpret_cast<const uint64_t*>(key.data());
-        const uint64_t* end = data + (key.length() / 8);
+        const uint64_t* data = reinterpret_cast<const uint64_t*>(key);
+        const uint64_t* end = data + (len / 8);
 
         while (data != end) {
             uint64_t k;
@@ -38,7 +43,7 @@ public:
 
         const unsigned char* data2 = reinterpret_cast<const unsigned char*>(data);
 
-        switch (key.length() & 7) {
+        switch (len & 7) {
             case 7: h ^= uint64_t(data2[6]) << 48; [[fallthrough]];
             case 6: h ^= uint64_t(data2[5]) << 40; [[fallthrough]];
             case 5: h ^= uint64_t(data2[4]) << 32; [[fallthrough]];
@@ -56,6 +61,60 @@ public:
         return h;
     }
 
+    // Same value as hash64() on little-endian hosts, evaluable at compile
+    // time. Constant evaluation assembles words byte by byte; at run time
+    // it takes the hash64_bytes() path.
+    static constexpr uint64_t hash64_view(std::string_view key, uint64_t seed = 0) {
+#if defined(__GNUC__) || defined(__clang__)
+        if (!__builtin_is_constant_evaluated()) {
+            return hash64_bytes(key.data(), key.size(), seed);
+        }
+#endif
+        const uint64_t m = 0xc6a4a7935bd1e995ULL;
+        const int r = 47;
+
+        uint64_t h = seed ^ (key.length() * m);
+
+        size_t blocks = key.length() / 8;
+        for (size_t b = 0; b < blocks; b++) {
+            uint64_t k = 0;
+            for (size_t i = 0; i < 8; i++) {
+                k |= uint64_t(static_cast<unsigned char>(key[b * 8 + i])) << (8 * i);
+            }
+
+            k *= m;
+            k ^= k >> r;
+            k *= m;
+
+            h ^= k;
+            h *= m;
+        }
+
+        size_t tail = key.length() & 7;
+        if (tail != 0) {
+            for (size_t i = 0; i < tail; i++) {
+                h ^= uint64_t(static_cast<unsigned char>(key[blocks * 8 + i])) << (8 * i);
+            }
+            h *= m;
+        }
+
+        h ^= h >> r;
+        h *= m;
+        h ^= h >> r;
+
+        return h;
+    }
+
+    // 64-bit finalizer (avalanche mix of an already-hashed value)
+    static constexpr uint64_t fmix64(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+
     // Generate three independent hash values for use in BDZ MPHF
     static void hash_triple(const std::string& key, uint64_t seed1, uint64_t seed2, uint64_t seed3,
                            size_t& h0, size_t& h1, size_t& h2, size_t table_size) {
@@ -0,0 +1,79 @@
+#ifndef NUMA_REPLICATED_HPP
+#define NUMA_REPLICATED_HPP
+
+#include "numa_topology.hpp"
+#include "lookup.hpp"
+#include <memory>
+#include <vector>
+#include <string>
+#include <thread>
+#include <iostream>
+#include <type_traits>
+
+namespace hashing {
+
+// One copy of a built, read-only index per NUMA node.
+//
+// On a multi-socket machine every lookup into a single copy that lives on
+// the other node crosses the interconnect, at roughly twice the latency of
+// a local miss. Each replica is copy-constructed by a thread bound to its
+// node, so first-touch places all of the replica's arrays (huge page
+// mappings included) in that node's memory. Lookup threads then call
+// local() and probe the copy next to them.
+//
+// On a single-node machine nothing is copied: local() is the original
+// model, which must then outlive this object (as must an explicitly passed
+// topology). Replicas are independent copies, so rebuilding the original
+// does not update them.
+template <typename Model>
+class NumaReplicated {
+    static_assert(std::is_base_of<HashModel, Model>::value, "Model must derive from HashModel");
+    static_assert(std::is_copy_constructible<Model>::value, "Replicated models are copied per node");
+
+public:
+    explicit NumaReplicated(const Model& model, const NumaTopology& topo = NumaTopology::system())
+        : topology(topo), original(&model) {
+        if (topology.numNodes() < 2) {
+            return;
+        }
+
+        replicas.resize(topology.numNodes());
+        for (size_t node = 0; node < replicas.size(); node++) {
+            // One node at a time: the copy is memory bound, and a failed
+            // bind is reported before the next node starts
+            bool bound = false;
+            std::thread worker([&, node] {
+                bound = topology.bindThread(node);
+                replicas[node] = std::make_unique<Model>(model);
+            });
+            worker.join();
+            if (!bound) {
+                std::cerr << "Warning: could not bind to NUMA node " << node
+                          << ", its replica may be allocated elsewhere\n";
+            }
+        }
+    }
+
+    // Replica on the calling thread's node
+    const Model& local() const { return replica(topology.currentNode()); }
+
+    const Model& replica(size_t node) const {
+        if (replicas.empty()) return *original;
+        return *replicas[node < replicas.size() ? node : 0];
+    }
+
+    // 1 when the original is used as is
+    size_t numReplicas() const { return replicas.empty() ? 1 : replicas.size(); }
+    const NumaTopology& getTopology() const { return topology; }
+
+    uint64_t hash(const std::string& key) const { return lookup(local(), key); }
+
+private:
+    const NumaTopology& topology;
+    const Model* original;
+    std::vector<std::unique_ptr<Model>> replicas;
+};
+
+} // namespace hashing
+
+#endif // NUMA_REPLICATED_HPP
@@ -0,0 +1,40 @@
+#ifndef NUMA_TOPOLOGY_HPP
+#define NUMA_TOPOLOGY_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace hashing {
+
+// NUMA nodes of the machine and the CPUs on each, read once from
+// /sys/devices/system/node. Node ids are renumbered densely from 0. Where
+// that interface is missing (non-Linux, containers hiding sysfs) the
+// machine is reported as one node.
+class NumaTopology {
+public:
+    // One node, no CPU list (binding is a no-op)
+    NumaTopology() = default;
+
+    // Explicit layout: node_cpus[i] lists the CPUs of node i
+    explicit NumaTopology(std::vector<std::vector<int>> node_cpus);
+
+    static const NumaTopology& system();
+
+    size_t numNodes() const { return node_cpus.empty() ? 1 : node_cpus.size(); }
+    const std::vector<int>& cpus(size_t node) const;
+
+    // Node of the CPU the calling thread is running on (0 when unknown)
+    size_t currentNode() const;
+
+    // Restrict the calling thread to the node's CPUs; false if that failed
+    bool bindThread(size_t node) const;
+
+private:
+    std::vector<std::vector<int>> node_cpus;
+    std::vector<uint16_t> cpu_node;  // CPU id -> node
+};
+
+} // namespace hashing
+
+#endif // NUMA_TOPOLOGY_HPP
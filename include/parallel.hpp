@@ -0,0 +1,38 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace hashing {
+
+// Split [0, n) into contiguous chunks and run body(begin, end) on each chunk
+// in its own thread. Chunk boundaries are multiples of `align` so callers
+// writing packed arrays never share a word between threads.
+template <typename Body>
+void parallel_for(size_t n, unsigned num_threads, Body body, size_t align = 64) {
+    if (num_threads <= 1 || n < 2 * align) {
+        body(size_t(0), n);
+        return;
+    }
+
+    size_t chunk = (n + num_threads - 1) / num_threads;
+    chunk = ((chunk + align - 1) / align) * align;
+
+    std::vector<std::thread> workers;
+    for (size_t begin = chunk; begin < n; begin += chunk) {
+        size_t end = std::min(n, begin + chunk);
+        workers.emplace_back([&body, begin, end]() { body(begin, end); });
+    }
+    body(size_t(0), std::min(n, chunk));
+
+    for (auto& t : workers) {
+        t.join();
+    }
+}
+
+} // namespace hashing
+
+#endif // PARALLEL_HPP
@@ -0,0 +1,74 @@
+#ifndef PARTITIONED_MPHF_HPP
+#define PARTITIONED_MPHF_HPP
+
+#include "base_hash.hpp"
+#include "bdz_core.hpp"
+#include "key_reader.hpp"
+#include <vector>
+#include <string>
+#include <random>
+
+namespace hashing {
+
+// Options for the out-of-core build
+struct ExternalBuildOptions {
+    std::string tmp_dir;              // Spill directory (empty: system temp dir)
+    unsigned partition_bits = 8;      // 2^bits partitions (one spill file each)
+    size_t spill_buffer_keys = 8192;  // Signatures buffered per partition before a write
+};
+
+// Partitioned BDZ MPHF with external-memory construction
+//
+// Architecture:
+// - 128-bit signature per key (two seeded MurmurHash3 passes)
+// - Top bits of the signature pick a partition
+// - One BDZCore per partition over the low 64 signature bits
+// - Global index = partition offset + in-partition rank
+//
+// buildExternal() reads the keys once, spills signatures (16 bytes/key) to one
+// temporary file per partition with sequential appends, then loads and builds
+// one partition at a time. Peak memory is the spill buffers plus a single
+// partition's build state, independent of the total key count.
+class PartitionedMPHF final : public HashModel {
+private:
+    struct Signature {
+        uint64_t hi;  // Partition selection
+        uint64_t lo;  // In-partition MPHF input
+    };
+
+    uint64_t sig_seed0 = 0, sig_seed1 = 0;
+    unsigned partition_bits = 0;
+    size_t num_keys = 0;
+    std::vector<BDZCore> partitions;
+    std::vector<uint64_t> offsets;  // First global index of each partition
+
+    ConstructionStats construction_stats;
+
+    Signature signature(const std::string& key) const;
+    size_t partition_of(const Signature& sig) const;
+    void init_seeds(std::mt19937_64& gen);
+    // BDZ over lo[0, n). Repeated (hi, lo) signatures are counted, then
+    // dropped (n shrinks, both columns compacted) or fail the partition;
+    // distinct signatures that share lo fail it too.
+    bool build_partition(size_t p, uint64_t* lo, uint64_t* hi, size_t& n, std::mt19937_64& gen);
+
+public:
+    // Keys per partition aimed for by the in-memory build()
+    static constexpr size_t TARGET_PARTITION_KEYS = 1 << 20;
+
+    std::string getName() const override { return "Partitioned BDZ MPHF (External-Memory Build)"; }
+    void build(const std::vector<std::string>& keys) override;
+    void buildExternal(KeyReader& reader, const ExternalBuildOptions& options);
+    uint64_t hash(const std::string& key) const override;
+    size_t getMemoryUsage() const override;
+    void printStats() const override;
+    ConstructionStats getConstructionStats() const override { return construction_stats; }
+    void save(std::ostream& out) const override;
+    void load(std::istream& in) override;
+
+    size_t numPartitions() const { return partitions.size(); }
+};
+
+} // namespace hashing
+
+#endif // PARTITIONED_MPHF_HPP
@@ -0,0 +1,38 @@
+#ifndef QUALITY_ANALYSIS_HPP
+#define QUALITY_ANALYSIS_HPP
+
+#include "base_hash.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace hashing {
+
+// Distribution-quality diagnostics for a built model.
+//
+// Builds no longer compute these; callers that want them (benchmarks,
+// research runs) ask for them explicitly after build(). Only a random
+// sample of the keys is looked up, in parallel, through the model's full
+// hash() path.
+struct QualityOptions {
+    size_t sample_size = 100000;  // Keys to look up (0: all keys)
+    size_t range = 0;             // Model output range (0: outputRange(), else keys.size())
+    unsigned num_threads = 1;
+    uint64_t seed = 0x9e3779b97f4a7c15ULL;  // Sample selection
+
+    QualityOptions() = default;
+};
+
+// Uniform random sample of n keys without replacement, in input order
+std::vector<std::string> sampleKeys(const std::vector<std::string>& keys, size_t n, uint64_t seed);
+
+// Model's construction stats with chi_square, max_load, collisions and
+// quality_sample filled from the sampled lookups. Chi-square is taken over
+// min(range, sample) equal-width buckets of the output range; lookups that
+// fail (UINT64_MAX) or fall outside the range are not bucketed.
+ConstructionStats analyzeQuality(const HashModel& model, const std::vector<std::string>& keys,
+                                 const QualityOptions& options = QualityOptions());
+
+} // namespace hashing
+
+#endif // QUALITY_ANALYSIS_HPP
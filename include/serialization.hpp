@@ -0,0 +1,73 @@
+#ifndef SERIALIZATION_HPP
+#define SERIALIZATION_HPP
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace hashing {
+namespace io {
+
+// Little helpers for the binary index format. Values are written in host
+// byte order; indexes are meant to move between machines of the same
+// architecture (build box -> serving nodes).
+
+template <typename T>
+void write_pod(std::ostream& out, const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "write_pod requires a trivially copyable type");
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    if (!out) throw std::runtime_error("Failed to write index data");
+}
+
+template <typename T>
+T read_pod(std::istream& in) {
+    static_assert(std::is_trivially_copyable<T>::value, "read_pod requires a trivially copyable type");
+    T value;
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!in) throw std::runtime_error("Unexpected end of index data");
+    return value;
+}
+
+template <typename T, typename Alloc>
+void write_vector(std::ostream& out, const std::vector<T, Alloc>& values) {
+    static_assert(std::is_trivially_copyable<T>::value, "write_vector requires a trivially copyable type");
+    write_pod<uint64_t>(out, values.size());
+    if (!values.empty()) {
+        out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+        if (!out) throw std::runtime_error("Failed to write index data");
+    }
+}
+
+template <typename T, typename Alloc>
+void read_vector(std::istream& in, std::vector<T, Alloc>& values) {
+    static_assert(std::is_trivially_copyable<T>::value, "read_vector requires a trivially copyable type");
+    uint64_t count = read_pod<uint64_t>(in);
+    values.resize(count);
+    if (count > 0) {
+        in.read(reinterpret_cast<char*>(values.data()), count * sizeof(T));
+        if (!in) throw std::runtime_error("Unexpected end of index data");
+    }
+}
+
+inline void write_string(std::ostream& out, const std::string& s) {
+    write_pod<uint64_t>(out, s.size());
+    out.write(s.data(), s.size());
+    if (!out) throw std::runtime_error("Failed to write index data");
+}
+
+inline std::string read_string(std::istream& in) {
+    uint64_t len = read_pod<uint64_t>(in);
+    std::string s(len, '\0');
+    in.read(&s[0], len);
+    if (!in) throw std::runtime_error("Unexpected end of index data");
+    return s;
+}
+
+} // namespace io
+} // namespace hashing
+
+#endif // SERIALIZATION_HPP
@@ -0,0 +1,177 @@
+#ifndef STATIC_PERFECT_HASH_HPP
+#define STATIC_PERFECT_HASH_HPP
+
+#include "murmur_hash.hpp"
+#include <array>
+#include <string_view>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+namespace hashing {
+
+// Compile-time minimal perfect hash for small fixed key sets (protocol
+// verbs, header names, enum-like tags).
+//
+// makeStaticPerfectHash() runs entirely in a constant expression: it
+// searches hash seeds and per-bucket displacements (hash-and-displace)
+// until every key has its own slot, and yields a table of plain arrays
+// with no heap use. Keys are hashed with the same MurmurHash3 as BDZ_MPHF.
+//
+// Lookup: one MurmurHash3 pass over the key, one displacement load, one
+// slot load and a string compare against the stored key, so keys outside
+// the set are rejected exactly. lookup() returns the key's position in the
+// list passed to makeStaticPerfectHash(), or NOT_FOUND.
+//
+//   constexpr auto verbs = makeStaticPerfectHash("GET", "PUT", "POST", "DELETE");
+//   static_assert(verbs.lookup("POST") == 2);
+//
+// Sized for tens to a few hundred keys; large sets exceed the compiler's
+// constant-evaluation budget and belong in a runtime BDZ build.
+template <size_t N>
+class StaticPerfectHash {
+public:
+    static constexpr uint64_t NOT_FOUND = UINT64_MAX;
+
+    constexpr uint64_t lookup(std::string_view key) const {
+        if constexpr (N == 0) {
+            return NOT_FOUND;
+        } else {
+            uint64_t h = MurmurHash3::hash64_view(key, seed);
+            uint32_t i = slot_index[slot_of(h, displacement[h % N])];
+            return keys[i] == key ? i : NOT_FOUND;
+        }
+    }
+
+    constexpr size_t size() const { return N; }
+    constexpr std::string_view key(size_t i) const { return keys[i]; }
+    constexpr size_t sizeInBytes() const { return sizeof(*this); }
+
+    // Slot for a key hash given its bucket's displacement word
+    static constexpr size_t slot_of(uint64_t h, uint32_t d) {
+        if (d & DIRECT) {
+            return d & ~DIRECT;  // Singleton bucket placed directly
+        }
+        return MurmurHash3::fmix64(h + d * 0x9e3779b97f4a7c15ULL) % N;
+    }
+
+    static constexpr uint32_t DIRECT = 0x80000000u;
+
+    uint64_t seed = 0;
+    std::array<uint32_t, N> displacement{};   // Per bucket (bucket = h % N)
+    std::array<uint32_t, N> slot_index{};     // Slot -> key position
+    std::array<std::string_view, N> keys{};   // In input order
+};
+
+namespace detail {
+
+constexpr uint32_t STATIC_PHF_MAX_SEEDS = 64;
+constexpr uint32_t STATIC_PHF_MAX_DISPLACEMENT = 1u << 16;
+
+// One seed attempt; false if some bucket found no displacement
+template <size_t N>
+constexpr bool try_static_phf_seed(StaticPerfectHash<N>& table, uint64_t seed) {
+    table.seed = seed;
+
+    std::array<uint64_t, N> hashes{};
+    std::array<size_t, N + 1> bucket_start{};
+    for (size_t i = 0; i < N; i++) {
+        hashes[i] = MurmurHash3::hash64_view(table.keys[i], seed);
+        bucket_start[hashes[i] % N + 1]++;
+    }
+    size_t max_bucket = 0;
+    for (size_t b = 0; b < N; b++) {
+        max_bucket = bucket_start[b + 1] > max_bucket ? bucket_start[b + 1] : max_bucket;
+        bucket_start[b + 1] += bucket_start[b];
+    }
+
+    // Keys grouped by bucket (counting sort)
+    std::array<size_t, N> members{};
+    std::array<size_t, N> cursor{};
+    for (size_t b = 0; b < N; b++) cursor[b] = bucket_start[b];
+    for (size_t i = 0; i < N; i++) {
+        members[cursor[hashes[i] % N]++] = i;
+    }
+
+    std::array<bool, N> used{};
+    for (size_t b = 0; b < N; b++) table.displacement[b] = 0;
+
+    // Largest buckets first, while the table is still empty
+    for (size_t size = max_bucket; size >= 2; size--) {
+        for (size_t b = 0; b < N; b++) {
+            size_t begin = bucket_start[b];
+            if (bucket_start[b + 1] - begin != size) continue;
+
+            bool placed = false;
+            for (uint32_t d = 0; d < STATIC_PHF_MAX_DISPLACEMENT && !placed; d++) {
+                placed = true;
+                for (size_t j = 0; j < size && placed; j++) {
+                    size_t slot = StaticPerfectHash<N>::slot_of(hashes[members[begin + j]], d);
+                    if (used[slot]) placed = false;
+                    for (size_t k = 0; k < j && placed; k++) {
+                        if (StaticPerfectHash<N>::slot_of(hashes[members[begin + k]], d) == slot) {
+                            placed = false;
+                        }
+                    }
+                }
+                if (placed) {
+                    table.displacement[b] = d;
+                    for (size_t j = 0; j < size; j++) {
+                        size_t slot = StaticPerfectHash<N>::slot_of(hashes[members[begin + j]], d);
+                        used[slot] = true;
+                        table.slot_index[slot] = static_cast<uint32_t>(members[begin + j]);
+                    }
+                }
+            }
+            if (!placed) return false;
+        }
+    }
+
+    // Singletons take the remaining slots directly
+    size_t free_slot = 0;
+    for (size_t b = 0; b < N; b++) {
+        if (bucket_start[b + 1] - bucket_start[b] != 1) continue;
+        while (used[free_slot]) free_slot++;
+        used[free_slot] = true;
+        table.displacement[b] = StaticPerfectHash<N>::DIRECT | static_cast<uint32_t>(free_slot);
+        table.slot_index[free_slot] = static_cast<uint32_t>(members[bucket_start[b]]);
+    }
+    return true;
+}
+
+} // namespace detail
+
+template <size_t N>
+constexpr StaticPerfectHash<N> makeStaticPerfectHash(const std::array<std::string_view, N>& keys) {
+    static_assert(N < StaticPerfectHash<N>::DIRECT, "Too many keys for a static perfect hash");
+
+    StaticPerfectHash<N> table;
+    for (size_t i = 0; i < N; i++) {
+        table.keys[i] = keys[i];
+        for (size_t j = 0; j < i; j++) {
+            if (keys[j] == keys[i]) {
+                throw std::invalid_argument("Duplicate key in static perfect hash");
+            }
+        }
+    }
+    if constexpr (N == 0) {
+        return table;
+    } else {
+        for (uint32_t attempt = 0; attempt < detail::STATIC_PHF_MAX_SEEDS; attempt++) {
+            if (detail::try_static_phf_seed(table, MurmurHash3::fmix64(attempt + 1))) {
+                return table;
+            }
+        }
+        throw std::runtime_error("Static perfect hash construction failed");
+    }
+}
+
+template <typename... Keys>
+constexpr StaticPerfectHash<sizeof...(Keys)> makeStaticPerfectHash(const Keys&... keys) {
+    return makeStaticPerfectHash<sizeof...(Keys)>(
+        std::array<std::string_view, sizeof...(Keys)>{std::string_view(keys)...});
+}
+
+} // namespace hashing
+
+#endif // STATIC_PERFECT_HASH_HPP
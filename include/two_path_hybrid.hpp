@@ -1,9 +1,10 @@
 #ifndef TWO_PATH_HYBRID_HPP
 #define TWO_PATH_HYBRID_HPP
 
-#include "base_hash.hpp"
+#include "hybrid_pipeline.hpp"
 #include <vector>
 #include <string>
+#include <random>
 
 namespace hashing {
 
@@ -12,53 +13,88 @@ namespace hashing {
 // Architecture:
 // Fast Lane:  SipHash-1-2 + Simple MPHF (no verification)
 // Secure Lane: SipHash-2-4 + BDZ + BLAKE3 (full security)
-// Router: Deterministic lane assignment via key hash LSB
-class TwoPathHybrid : public HashModel {
+// Router: Deterministic lane assignment via key hash LSB, or (buildWeighted)
+//         a routing bitmap built from per-key traffic
+//
+// Each lane is a HybridPipeline built over its own keys, so each lane's
+// tables are sized to its key count. The fast lane's SipHash value does
+// double duty as the routing hash and the fast lane's MPHF input.
+// Fast lane keys map to [0, fast_n), secure lane keys to [fast_n, n).
+//
+// Traffic-aware routing: buildWeighted() picks the hottest fastLaneShare()
+// of the keys among those not flagged sensitive and sets their cells in a
+// bitmap of ROUTE_CELLS_PER_HOT_KEY cells per hot key, indexed by the
+// routing hash. A cell shared with a sensitive key stays clear, so the hot
+// key falls back to the secure lane. Any key whose cell is set (hot, or a
+// cold key that shares a hot key's cell) is on the fast lane, so the router
+// answers for every key in one bitmap probe. Absent keys reach the
+// unverified lane only through set cells (about 1 in 9 instead of 1 in 2).
+using FastLanePipeline = HybridPipeline<SipHash12Preprocessor, NoFilter, BDZIndex, NoVerifier>;
+using SecureLanePipeline = HybridPipeline<SipHash24Preprocessor, NoFilter, BDZIndex, FingerprintVerifier>;
+
+class TwoPathHybrid final : public HashModel {
 private:
-    // Fast lane structures
-    uint64_t fast_sip_key0, fast_sip_key1;
-    std::vector<uint8_t> fast_g_table;
-    size_t fast_table_size;
-    uint64_t fast_seeds[3];
-    
-    // Secure lane structures
-    uint64_t secure_sip_key0, secure_sip_key1;
-    std::vector<uint8_t> secure_g_table;
-    size_t secure_table_size;
-    uint64_t secure_seeds[3];
-    std::vector<uint64_t> secure_fingerprints;
-    
-    size_t num_keys;
+    FastLanePipeline fast_lane;
+    SecureLanePipeline secure_lane;
+    size_t num_keys = 0;
+
+    // Traffic-aware routing (empty: LSB routing)
+    std::vector<uint64_t> route_bits;
+    uint64_t route_cells = 0;
+    double fast_lane_share = 0.2;
+    size_t hot_keys = 0;       // Chosen for the fast lane at build time
+    size_t demoted_keys = 0;   // Of those, kept secure by a sensitive key's cell
 
     ConstructionStats construction_stats;
 
     // Routing
-    bool route_to_secure_lane(const std::string& key) const;
-    
-    // Fast lane operations
-    uint64_t fast_siphash(const std::string& key) const;
-    size_t fast_mphf(uint64_t preprocessed) const;
-    
-    // Secure lane operations
-    uint64_t secure_siphash(const std::string& key) const;
-    size_t secure_mphf(uint64_t preprocessed) const;
-    uint64_t blake3_stage(const std::string& key) const;
-    
-    void compute_mphf_hashes(uint64_t preprocessed, const uint64_t seeds[3],
-                            size_t table_sz, size_t& h0, size_t& h1, size_t& h2) const;
-    bool build_mphf(const std::vector<std::string>& keys, std::vector<uint8_t>& g_table,
-                   size_t table_sz, const uint64_t seeds[3], uint64_t sip_k0, uint64_t sip_k1);
-    double compute_chi_square(const std::vector<std::string>& keys) const;
+    bool route_to_secure_lane(uint64_t fast_hash) const;
+    uint64_t route_cell(uint64_t fast_hash) const;
+    void build_router(const std::vector<uint64_t>& fast_hashes, const std::vector<double>& weights,
+                      const std::vector<uint8_t>& sensitive);
+
+    // Routing hash of every key, then lane SipHash and (secure lane)
+    // fingerprint, in key order. With traffic (weights or sensitive given)
+    // the router is built from the routing hashes in between.
+    void hash_keys(const std::vector<std::string>& keys, std::mt19937_64& gen,
+                   KeySignatures& all, std::vector<uint8_t>& secure,
+                   const std::vector<double>* weights = nullptr, const std::vector<uint8_t>* sensitive = nullptr);
+    bool build_lanes(const KeySignatures& all, const std::vector<uint8_t>& secure, std::mt19937_64& gen);
+    void build_without_repeats(KeySignatures& all, std::vector<uint8_t>& secure, std::mt19937_64& gen,
+                               const std::vector<std::string>& keys);
+    void store_keys(const std::vector<std::string>& keys);
 
 public:
+    static constexpr uint64_t ROUTE_CELLS_PER_HOT_KEY = 8;
+
     std::string getName() const override { 
         return "Two-Path Hybrid: Dual (Fast + Secure) Lanes"; 
     }
     void build(const std::vector<std::string>& keys) override;
+
+    // Traffic-aware build. weights[i] is key i's access frequency; a nonzero
+    // sensitive[i] keeps key i on the secure lane. Either may be empty: no
+    // weights puts every non-sensitive key on the fast lane, no flags leaves
+    // the choice to the weights.
+    void buildWeighted(const std::vector<std::string>& keys, const std::vector<double>& weights,
+                       const std::vector<uint8_t>& sensitive = {});
+
+    // Share of all keys buildWeighted() puts on the fast lane, hottest first
+    // (default 0.2)
+    void setFastLaneShare(double share);
+    double fastLaneShare() const { return fast_lane_share; }
+    bool trafficAware() const { return route_cells != 0; }
+
     uint64_t hash(const std::string& key) const override;
+#ifdef HASHING_COROUTINES
+    // hash(key) for lookupInterleaved(): routes, then runs the lane's lookup coroutine
+    LookupTask hashCoroutine(const std::string& key) const;
+#endif
     size_t getMemoryUsage() const override;
     void printStats() const override;
     ConstructionStats getConstructionStats() const override { return construction_stats; }
+    void save(std::ostream& out) const override;
+    void load(std::istream& in) override;
 };
 
 } // namespace hashing
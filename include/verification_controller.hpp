@@ -0,0 +1,174 @@
+#ifndef VERIFICATION_CONTROLLER_HPP
+#define VERIFICATION_CONTROLLER_HPP
+
+#include "serialization.hpp"
+#include <atomic>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+namespace hashing {
+
+// Bounds and thresholds of an adaptive verification rate. Rates are powers
+// of two: a shift s verifies 1 in 2^s lookups.
+struct AdaptiveVerificationConfig {
+    unsigned min_shift = 0;          // Highest rate, used under attack (0: every lookup)
+    unsigned max_shift = 8;          // Lowest rate, used for calm traffic (8: 1 in 256)
+    uint32_t window = 4096;          // Lookups per thread between rate decisions
+    double raise_above = 1.0 / 16;   // Failed share of checks that jumps to min_shift
+    double lower_below = 1.0 / 64;   // Failed share under which the rate halves
+};
+
+// Sampling rate of a fingerprint verifier, driven by the lookups it sees.
+//
+// A failed check means a key outside the set reached a slot; the failed
+// share of checks estimates how much of the traffic consists of such keys.
+// Sampling on bits of the keyed preprocessing hash keeps that estimate
+// unbiased: without the key, a client cannot aim at unsampled lookups.
+//
+// Each thread counts lookups, checks and failures in its own cache line
+// (plain relaxed loads and stores, no locked instructions). Every `window`
+// lookups the thread decides: above raise_above the shared rate jumps to
+// the highest bound, below lower_below it halves, in between it holds.
+// Threads beyond COUNTER_SLOTS share slots and may lose a few counts.
+class VerificationController {
+public:
+    static constexpr unsigned NEVER = 64;  // Shift that verifies nothing
+    static constexpr size_t COUNTER_SLOTS = 16;
+
+    VerificationController() = default;
+
+    // Copies (NumaReplicated, ...) keep the configuration and current rate
+    // and start with fresh counters
+    VerificationController(const VerificationController& other) { *this = other; }
+    VerificationController& operator=(const VerificationController& other) {
+        if (this != &other) {
+            config = other.config;
+            enabled = other.enabled;
+            shift.store(other.shift.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            raises.store(other.raises.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            for (auto& slot : slots) slot.clear();
+        }
+        return *this;
+    }
+
+    // Fixed rate, no counting
+    void setFixed(unsigned fixed_shift) {
+        enabled = false;
+        shift.store(std::min(fixed_shift, NEVER), std::memory_order_relaxed);
+    }
+
+    // Adaptive rate within the configured bounds, starting at the lowest
+    void setAdaptive(const AdaptiveVerificationConfig& adaptive) {
+        if (adaptive.min_shift > adaptive.max_shift || adaptive.max_shift > 63 || adaptive.window == 0 ||
+            adaptive.lower_below > adaptive.raise_above) {
+            throw std::invalid_argument("Invalid adaptive verification bounds");
+        }
+        config = adaptive;
+        enabled = true;
+        shift.store(config.max_shift, std::memory_order_relaxed);
+        raises.store(0, std::memory_order_relaxed);
+        for (auto& slot : slots) slot.clear();
+    }
+
+    bool adaptive() const { return enabled; }
+    const AdaptiveVerificationConfig& adaptiveConfig() const { return config; }
+    unsigned currentShift() const { return shift.load(std::memory_order_relaxed); }
+    uint64_t raiseCount() const { return raises.load(std::memory_order_relaxed); }
+
+    // Whether this lookup is checked, from the low bits of its keyed hash
+    bool sampled(uint64_t preprocessed) const {
+        unsigned s = currentShift();
+        return s < NEVER && (preprocessed & ((uint64_t(1) << s) - 1)) == 0;
+    }
+
+    // Count one lookup (checked or not) and its outcome
+    void record(bool checked, bool passed) const {
+        if (!enabled) return;
+        Counters& c = slots[thread_slot()];
+        uint32_t lookups = c.lookups.load(std::memory_order_relaxed) + 1;
+        c.lookups.store(lookups, std::memory_order_relaxed);
+        if (checked) {
+            c.checks.store(c.checks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            if (!passed) c.failures.store(c.failures.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        if (lookups >= config.window) decide(c);
+    }
+
+    void save(std::ostream& out) const {
+        io::write_pod<uint8_t>(out, enabled ? 1 : 0);
+        if (!enabled) return;
+        io::write_pod<uint32_t>(out, config.min_shift);
+        io::write_pod<uint32_t>(out, config.max_shift);
+        io::write_pod<uint32_t>(out, config.window);
+        io::write_pod<double>(out, config.raise_above);
+        io::write_pod<double>(out, config.lower_below);
+    }
+
+    // Adaptive state only; a fixed rate is restored by the verifier
+    void load(std::istream& in) {
+        enabled = false;
+        if (io::read_pod<uint8_t>(in) == 0) return;
+        AdaptiveVerificationConfig loaded;
+        loaded.min_shift = io::read_pod<uint32_t>(in);
+        loaded.max_shift = io::read_pod<uint32_t>(in);
+        loaded.window = io::read_pod<uint32_t>(in);
+        loaded.raise_above = io::read_pod<double>(in);
+        loaded.lower_below = io::read_pod<double>(in);
+        try {
+            setAdaptive(loaded);
+        } catch (const std::invalid_argument&) {
+            throw std::runtime_error("Corrupt adaptive verification settings");
+        }
+    }
+
+private:
+    struct alignas(64) Counters {
+        std::atomic<uint32_t> lookups{0};
+        std::atomic<uint32_t> checks{0};
+        std::atomic<uint32_t> failures{0};
+
+        void clear() {
+            lookups.store(0, std::memory_order_relaxed);
+            checks.store(0, std::memory_order_relaxed);
+            failures.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    AdaptiveVerificationConfig config;
+    bool enabled = false;
+    mutable std::atomic<unsigned> shift{NEVER};
+    mutable std::atomic<uint64_t> raises{0};
+    mutable std::array<Counters, COUNTER_SLOTS> slots;
+
+    // Threads take slots round robin on first use
+    static size_t thread_slot() {
+        static std::atomic<size_t> next{0};
+        thread_local size_t slot = next.fetch_add(1, std::memory_order_relaxed) % COUNTER_SLOTS;
+        return slot;
+    }
+
+    void decide(Counters& c) const {
+        uint32_t checks = c.checks.load(std::memory_order_relaxed);
+        uint32_t failures = c.failures.load(std::memory_order_relaxed);
+        c.clear();
+        if (checks == 0) return;
+
+        double failed = static_cast<double>(failures) / checks;
+        unsigned current = currentShift();
+        if (failed > config.raise_above) {
+            if (current != config.min_shift) {
+                shift.store(config.min_shift, std::memory_order_relaxed);
+                raises.fetch_add(1, std::memory_order_relaxed);
+            }
+        } else if (failed < config.lower_below && current < config.max_shift) {
+            // Concurrent deciders lower by one step in total
+            shift.compare_exchange_strong(current, current + 1, std::memory_order_relaxed);
+        }
+    }
+};
+
+} // namespace hashing
+
+#endif // VERIFICATION_CONTROLLER_HPP
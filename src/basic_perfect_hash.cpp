@@ -1,97 +1,162 @@
 #include "basic_perfect_hash.hpp"
+#include "hash_util.hpp"
+#include "key_signature.hpp"
+#include "murmur_hash.hpp"
 #include <random>
-#include <unordered_map>
 #include <iostream>
+#include <iomanip>
+#include <stdexcept>
 
 namespace hashing {
 
-uint64_t BasicPerfectHash::hash_function(const std::string& key, uint64_t seed) const {
-    uint64_t hash = seed;
-    for (char c : key) {
-        hash = hash * 31 + static_cast<uint64_t>(c);
-    }
-    return hash;
+uint64_t BasicPerfectHash::signature(const std::string& key) const {
+    return MurmurHash3::hash64(key, signature_seed);
 }
 
-void BasicPerfectHash::build(const std::vector<std::string>& keys) {
-    num_keys = keys.size();
-    size_t m = num_keys;  // First level size
-    
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-    primary_seed = gen();
-    
-    // First level: distribute keys into buckets
-    std::unordered_map<size_t, std::vector<std::string>> buckets;
-    for (const auto& key : keys) {
-        size_t bucket = hash_function(key, primary_seed) % m;
-        buckets[bucket].push_back(key);
-    }
-    
-    // Second level: build collision-free tables
-    first_level.resize(m);
-    for (size_t i = 0; i < m; i++) {
-        if (buckets.find(i) != buckets.end()) {
-            const auto& bucket_keys = buckets[i];
-            size_t n_i = bucket_keys.size();
-            first_level[i].size = n_i * n_i;  // Quadratic size for collision-free
-            
-            bool success = false;
-            for (int attempts = 0; attempts < 100 && !success; attempts++) {
-                first_level[i].seed = gen();
-                success = build_second_level(i, bucket_keys);
-            }
+size_t BasicPerfectHash::bucket_of(uint64_t sig) const {
+    return fastrange32(static_cast<uint32_t>(MurmurHash3::fmix64(sig ^ primary_seed)), num_buckets());
+}
+
+size_t BasicPerfectHash::slot_of(uint64_t sig, uint32_t seed, size_t size) {
+    uint64_t h = MurmurHash3::fmix64(sig ^ (seed * 0x9e3779b97f4a7c15ULL));
+    return fastrange32(static_cast<uint32_t>(h >> 32), size);
+}
+
+bool BasicPerfectHash::place_bucket(size_t bucket, const uint64_t* sigs, size_t n, std::mt19937_64& gen) {
+    size_t begin = buckets[bucket].offset;
+    size_t size = n * n;
+
+    for (int attempt = 0; attempt < MAX_BUCKET_ATTEMPTS; attempt++) {
+        uint32_t seed = static_cast<uint32_t>(gen());
+        size_t placed = 0;
+        for (; placed < n; placed++) {
+            size_t slot = begin + slot_of(sigs[placed], seed, size);
+            uint64_t bit = 1ULL << (slot % 32);
+            if (slot_words[slot / 32] & bit) break;  // Collision
+            slot_words[slot / 32] |= bit;
+        }
+        if (placed == n) {
+            buckets[bucket].seed = seed;
+            return true;
+        }
+        // Undo this attempt's bits
+        for (size_t j = 0; j < placed; j++) {
+            size_t slot = begin + slot_of(sigs[j], seed, size);
+            slot_words[slot / 32] &= ~(1ULL << (slot % 32));
         }
     }
+    return false;  // Only when signatures coincide
 }
 
-bool BasicPerfectHash::build_second_level(size_t index, const std::vector<std::string>& bucket_keys) {
-    auto& level = first_level[index];
-    level.table.clear();
-    level.table.resize(level.size);
-    
-    std::vector<bool> used(level.size, false);
-    
-    for (const auto& key : bucket_keys) {
-        size_t pos = hash_function(key, level.seed) % level.size;
-        if (used[pos]) {
-            return false;  // Collision detected
+bool BasicPerfectHash::build_buckets(const std::vector<uint64_t>& sigs, std::mt19937_64& gen) {
+    size_t m = num_buckets();
+    size_t max_slots = static_cast<size_t>(MAX_SLOTS_PER_KEY * num_keys) + 32;
+
+    // Bucket sizes, redrawing the primary seed until sum(n_i^2) fits
+    std::vector<uint32_t> counts(m + 1);
+    size_t total_slots = 0;
+    do {
+        construction_stats.attempts++;
+        if (construction_stats.attempts > MAX_PRIMARY_ATTEMPTS) return false;
+
+        primary_seed = gen();
+        std::fill(counts.begin(), counts.end(), 0);
+        for (uint64_t sig : sigs) {
+            counts[bucket_of(sig) + 1]++;
+        }
+        total_slots = 0;
+        for (size_t b = 1; b <= m; b++) {
+            total_slots += size_t(counts[b]) * counts[b];
+        }
+    } while (total_slots > max_slots);
+
+    // Counting sort of the signatures by bucket, slot offsets from n_i^2
+    buckets[0] = Bucket{0, 0};
+    for (size_t b = 0; b < m; b++) {
+        buckets[b + 1] = Bucket{buckets[b].offset + counts[b + 1] * counts[b + 1], 0};
+        counts[b + 1] += counts[b];
+    }
+    std::vector<uint64_t> grouped(num_keys);
+    for (uint64_t sig : sigs) {
+        grouped[counts[bucket_of(sig)]++] = sig;
+    }
+    // counts[b] now holds the end of bucket b, counts[b - 1] its start
+
+    slot_words.assign((total_slots + 31) / 32, 0);
+    for (size_t b = 0; b < m; b++) {
+        size_t start = b == 0 ? 0 : counts[b - 1];
+        size_t n = counts[b] - start;
+        if (n > 0 && !place_bucket(b, grouped.data() + start, n, gen)) {
+            return false;
         }
-        used[pos] = true;
-        level.table[pos] = key;
+    }
+
+    uint64_t rank = 0;
+    for (uint64_t& word : slot_words) {
+        word |= rank << 32;
+        rank += popcount64(word & 0xFFFFFFFFULL);
     }
     return true;
 }
 
+void BasicPerfectHash::build(const std::vector<std::string>& keys) {
+    if (keys.size() >= UINT32_MAX / 4) {
+        throw std::length_error("BasicPerfectHash supports fewer than 2^30 keys");
+    }
+
+    num_keys = keys.size();
+    construction_stats = ConstructionStats();
+    std::mt19937_64 gen = build_rng();
+
+    buckets.assign(num_keys + 1, Bucket{0, 0});
+    bool success = num_keys == 0;
+    while (!success && construction_stats.attempts < MAX_PRIMARY_ATTEMPTS) {
+        // Hash every key once; only a signature collision forces a rehash
+        signature_seed = gen();
+        KeySignatures sigs = compute_signatures(keys, build_config.num_threads,
+            [this](const std::string& key) { return signature(key); });
+        success = build_buckets(sigs.index_hashes, gen);
+    }
+
+    construction_stats.success = success;
+    if (!success) {
+        std::cerr << "Warning: FKS construction failed after "
+                  << construction_stats.attempts << " attempts\n";
+    }
+}
+
 uint64_t BasicPerfectHash::hash(const std::string& key) const {
-    size_t bucket = hash_function(key, primary_seed) % first_level.size();
-    const auto& level = first_level[bucket];
-    
-    if (level.size == 0) return 0;
-    
-    size_t pos = hash_function(key, level.seed) % level.size;
-    return bucket * 1000000 + pos;  // Unique ID
+    if (num_keys == 0) return UINT64_MAX;
+
+    uint64_t sig = signature(key);
+    size_t bucket = bucket_of(sig);
+    size_t begin = buckets[bucket].offset;
+    size_t size = buckets[bucket + 1].offset - begin;
+    if (size == 0) return UINT64_MAX;
+
+    size_t slot = begin + slot_of(sig, buckets[bucket].seed, size);
+    uint64_t word = slot_words[slot / 32];
+    uint64_t bit = 1ULL << (slot % 32);
+    if ((word & bit) == 0) return UINT64_MAX;
+
+    return (word >> 32) + popcount64(word & (bit - 1));
 }
 
 size_t BasicPerfectHash::getMemoryUsage() const {
-    size_t total = sizeof(*this);
-    for (const auto& level : first_level) {
-        total += level.table.capacity() * sizeof(std::string);
-        for (const auto& str : level.table) {
-            total += str.capacity();
-        }
-    }
-    return total;
+    return sizeof(*this) +
+           buckets.size() * sizeof(Bucket) +
+           slot_words.size() * sizeof(uint64_t);
 }
 
 void BasicPerfectHash::printStats() const {
-    std::cout << "  First level buckets: " << first_level.size() << "\n";
-    size_t total_second_level = 0;
-    for (const auto& level : first_level) {
-        total_second_level += level.size;
-    }
+    size_t total_second_level = buckets.empty() ? 0 : buckets.back().offset;
+    std::cout << "  First level buckets: " << num_buckets() << "\n";
     std::cout << "  Total second level slots: " << total_second_level << "\n";
+    if (num_keys == 0) return;
     std::cout << "  Space overhead: " << (double)total_second_level / num_keys << "x\n";
+    std::cout << "  Bits/key: " << std::fixed << std::setprecision(2)
+              << (getMemoryUsage() * 8.0 / num_keys) << "\n";
+    std::cout << "  Primary seed draws: " << construction_stats.attempts << "\n";
 }
 
 } // namespace hashing
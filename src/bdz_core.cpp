@@ -0,0 +1,590 @@
+#include "bdz_core.hpp"
+#include "hash_util.hpp"
+#include "murmur_hash.hpp"
+#include "serialization.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+    #include <immintrin.h>
+    #define BDZ_CORE_AVX512 1
+#elif defined(__AVX2__)
+    #include <immintrin.h>
+    #define BDZ_CORE_AVX2 1
+#endif
+
+#if defined(BDZ_CORE_AVX512) || defined(BDZ_CORE_AVX2)
+    #define BDZ_CORE_SIMD 1
+#endif
+
+namespace hashing {
+
+namespace {
+
+// Fields equal to 3 (unused vertices) in the low `fields` 2-bit slots of w
+inline unsigned unused_fields(uint64_t w, unsigned fields) {
+    uint64_t both = w & (w >> 1) & 0x5555555555555555ULL;
+    if (fields < 32) {
+        both &= (1ULL << (fields * 2)) - 1;
+    }
+    return popcount64(both);
+}
+
+// Base-3 digits of every byte value: digits[b][i] = (b / 3^i) mod 3
+struct TernaryTable {
+    uint8_t digits[256][5];
+
+    constexpr TernaryTable() : digits() {
+        for (unsigned b = 0; b < 256; b++) {
+            unsigned x = b;
+            for (unsigned i = 0; i < 5; i++) {
+                digits[b][i] = static_cast<uint8_t>(x % 3);
+                x /= 3;
+            }
+        }
+    }
+};
+
+constexpr TernaryTable TERNARY_TABLE;
+
+#ifdef BDZ_CORE_SIMD
+
+// 64-bit lane operations for lookup_group(), one register per group
+namespace simd {
+
+#ifdef BDZ_CORE_AVX512
+using vec = __m512i;
+constexpr size_t LANES = 8;
+
+inline vec load(const uint64_t* p) { return _mm512_loadu_si512(p); }
+inline void store(uint64_t* p, vec x) { _mm512_storeu_si512(p, x); }
+inline vec set1(uint64_t x) { return _mm512_set1_epi64(static_cast<long long>(x)); }
+inline vec add(vec a, vec b) { return _mm512_add_epi64(a, b); }
+inline vec sub(vec a, vec b) { return _mm512_sub_epi64(a, b); }
+inline vec bit_and(vec a, vec b) { return _mm512_and_si512(a, b); }
+inline vec bit_andnot(vec a, vec b) { return _mm512_andnot_si512(a, b); }
+inline vec bit_or(vec a, vec b) { return _mm512_or_si512(a, b); }
+inline vec bit_xor(vec a, vec b) { return _mm512_xor_si512(a, b); }
+template <unsigned N> vec srli(vec a) { return _mm512_srli_epi64(a, N); }
+template <unsigned N> vec slli(vec a) { return _mm512_slli_epi64(a, N); }
+inline vec srlv(vec a, vec count) { return _mm512_srlv_epi64(a, count); }
+inline vec mullo(vec a, vec b) { return _mm512_mullo_epi64(a, b); }
+inline vec mul32(vec a, vec b) { return _mm512_mul_epu32(a, b); }
+inline vec gt(vec a, vec b) { return _mm512_movm_epi64(_mm512_cmpgt_epi64_mask(a, b)); }
+inline vec eq(vec a, vec b) { return _mm512_movm_epi64(_mm512_cmpeq_epi64_mask(a, b)); }
+inline vec gather(const uint64_t* base, vec index) { return _mm512_i64gather_epi64(index, base, 8); }
+#else
+using vec = __m256i;
+constexpr size_t LANES = 4;
+
+inline vec load(const uint64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+inline void store(uint64_t* p, vec x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+inline vec set1(uint64_t x) { return _mm256_set1_epi64x(static_cast<long long>(x)); }
+inline vec add(vec a, vec b) { return _mm256_add_epi64(a, b); }
+inline vec sub(vec a, vec b) { return _mm256_sub_epi64(a, b); }
+inline vec bit_and(vec a, vec b) { return _mm256_and_si256(a, b); }
+inline vec bit_andnot(vec a, vec b) { return _mm256_andnot_si256(a, b); }
+inline vec bit_or(vec a, vec b) { return _mm256_or_si256(a, b); }
+inline vec bit_xor(vec a, vec b) { return _mm256_xor_si256(a, b); }
+template <unsigned N> vec srli(vec a) { return _mm256_srli_epi64(a, N); }
+template <unsigned N> vec slli(vec a) { return _mm256_slli_epi64(a, N); }
+inline vec srlv(vec a, vec count) { return _mm256_srlv_epi64(a, count); }
+inline vec mul32(vec a, vec b) { return _mm256_mul_epu32(a, b); }
+// No 64-bit multiply below AVX-512DQ: three 32x32 products
+inline vec mullo(vec a, vec b) {
+    vec cross = add(mul32(srli<32>(a), b), mul32(a, srli<32>(b)));
+    return add(mul32(a, b), slli<32>(cross));
+}
+// Signed compare; every compared value is below 2^63
+inline vec gt(vec a, vec b) { return _mm256_cmpgt_epi64(a, b); }
+inline vec eq(vec a, vec b) { return _mm256_cmpeq_epi64(a, b); }
+inline vec gather(const uint64_t* base, vec index) {
+    return _mm256_i64gather_epi64(reinterpret_cast<const long long*>(base), index, 8);
+}
+#endif
+
+inline vec select(vec mask, vec a, vec b) { return bit_or(bit_and(mask, a), bit_andnot(mask, b)); }
+
+inline vec fmix64(vec k) {
+    k = bit_xor(k, srli<33>(k));
+    k = mullo(k, set1(0xff51afd7ed558ccdULL));
+    k = bit_xor(k, srli<33>(k));
+    k = mullo(k, set1(0xc4ceb9fe1a85ec53ULL));
+    return bit_xor(k, srli<33>(k));
+}
+
+// fastrange32 of each lane's low 32 bits; range must be below 2^32
+inline vec fastrange32(vec h, vec range) { return srli<32>(mul32(h, range)); }
+
+} // namespace simd
+
+#endif // BDZ_CORE_SIMD
+
+} // namespace
+
+void BDZCore::vertices(uint64_t signature, size_t v[3]) const {
+    uint64_t a = MurmurHash3::fmix64(signature ^ seed);
+    uint64_t b = MurmurHash3::fmix64(a ^ 0x9e3779b97f4a7c15ULL);
+    if (vertex_layout == Layout::BLOCKED) {
+        // Both halves of one block, then any vertex outside it
+        constexpr size_t HALF = BLOCK_VERTICES / 2;
+        size_t base = fastrange32(static_cast<uint32_t>(b >> 32), num_blocks) * BLOCK_VERTICES;
+        v[0] = base + fastrange32(static_cast<uint32_t>(a), HALF);
+        v[1] = base + HALF + fastrange32(static_cast<uint32_t>(a >> 32), HALF);
+        size_t other = fastrange32(static_cast<uint32_t>(b), num_blocks - 1) * BLOCK_VERTICES;
+        v[2] = (other >= base ? other + BLOCK_VERTICES : other) + (a & (BLOCK_VERTICES - 1));
+        return;
+    }
+    v[0] = fastrange32(static_cast<uint32_t>(a), segment_size);
+    v[1] = segment_size + fastrange32(static_cast<uint32_t>(a >> 32), segment_size);
+    v[2] = 2 * segment_size + fastrange32(static_cast<uint32_t>(b), segment_size);
+}
+
+void BDZCore::set_g(size_t v, uint8_t value) {
+    uint64_t& word = g_lines[v / VERTICES_PER_LINE].words[(v / VERTICES_PER_WORD) % WORDS_PER_LINE];
+    unsigned shift = (v % VERTICES_PER_WORD) * 2;
+    word = (word & ~(0x03ULL << shift)) | (static_cast<uint64_t>(value & 0x03) << shift);
+}
+
+// Used vertices before v within its own line
+uint64_t BDZCore::rank_in_line(size_t v) const {
+    const GLine& line = g_lines[v / VERTICES_PER_LINE];
+    uint64_t r = 0;
+
+    size_t last = (v % VERTICES_PER_LINE) / VERTICES_PER_WORD;
+    for (size_t word = 0; word < last; word++) {
+        r += VERTICES_PER_WORD - unused_fields(line.words[word], VERTICES_PER_WORD);
+    }
+
+    unsigned fields = v % VERTICES_PER_WORD;
+    r += fields - unused_fields(line.words[last], fields);
+    return r;
+}
+
+// Re-encode the 2-bit table as base-3 digits; unused vertices (3) become 0,
+// the same value mod 3, and the rank directory is dropped
+void BDZCore::pack_ternary() {
+    g_trits.assign((table_size + VERTICES_PER_BYTE - 1) / VERTICES_PER_BYTE, 0);
+    for (size_t byte = 0; byte < g_trits.size(); byte++) {
+        unsigned value = 0;
+        size_t first = byte * VERTICES_PER_BYTE;
+        size_t last = std::min(first + VERTICES_PER_BYTE, table_size);
+        for (size_t v = last; v-- > first;) {
+            value = value * 3 + get_g(v) % 3;
+        }
+        g_trits[byte] = static_cast<uint8_t>(value);
+    }
+    HugeVector<GLine>().swap(g_lines);
+    HugeVector<uint32_t>().swap(rank_samples);
+}
+
+void BDZCore::set_table_size(size_t size) {
+    table_size = size;
+    segment_size = size / 3;
+    num_blocks = size / BLOCK_VERTICES;
+}
+
+bool BDZCore::build(const uint64_t* signatures, size_t n, uint64_t build_seed, double table_factor,
+                    GEncoding encoding, Layout layout, bool divert_core) {
+    if (n >= UINT32_MAX) {
+        throw std::length_error("BDZCore supports at most 2^32-1 keys per table");
+    }
+    if (divert_core && encoding != GEncoding::TWO_BIT) {
+        throw std::invalid_argument("BDZCore can only divert the 2-core with the TWO_BIT encoding");
+    }
+
+    g_encoding = encoding;
+    vertex_layout = layout;
+    g_trits.clear();
+    fallback.clear();
+    equal_signatures = false;
+    num_keys = n;
+    seed = build_seed;
+    if (layout == Layout::BLOCKED) {
+        // At least two blocks, so the third vertex has somewhere to go
+        size_t blocks = static_cast<size_t>(table_factor * n / BLOCK_VERTICES) + 1;
+        set_table_size(std::max<size_t>(blocks, 2) * BLOCK_VERTICES);
+    } else {
+        // Two vertices per segment at least: with one, any two keys share
+        // all three vertices and never peel
+        set_table_size(3 * std::max<size_t>(static_cast<size_t>(table_factor * n / 3.0) + 1, n > 1 ? 2 : 1));
+    }
+    // The peel keeps vertex ids in 32 bits and vertices() spreads 32-bit
+    // hashes over the table, so larger tables would alias vertices
+    if (table_size > UINT32_MAX) {
+        throw std::length_error("BDZCore supports at most 2^32 vertices per table (about " +
+                                std::to_string(static_cast<uint64_t>(UINT32_MAX / table_factor)) +
+                                " keys at this load factor); partition larger key sets");
+    }
+
+    // Hypergraph as (degree, XOR of incident edge ids) per vertex
+    std::vector<uint8_t> degree(table_size, 0);
+    std::vector<uint32_t> edge_xor(table_size, 0);
+
+    for (size_t i = 0; i < n; i++) {
+        size_t v[3];
+        vertices(signatures[i], v);
+        for (size_t j = 0; j < 3; j++) {
+            if (++degree[v[j]] == 0) {
+                // Degree overflow: hopeless graph, most likely repeated keys
+                std::vector<uint64_t> sorted(signatures, signatures + n);
+                std::sort(sorted.begin(), sorted.end());
+                equal_signatures = std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end();
+                return false;
+            }
+            edge_xor[v[j]] ^= static_cast<uint32_t>(i);
+        }
+    }
+
+    // Peeling: repeatedly remove an edge hanging off a degree-1 vertex
+    std::vector<uint32_t> stack;
+    for (size_t v = 0; v < table_size; v++) {
+        if (degree[v] == 1) stack.push_back(static_cast<uint32_t>(v));
+    }
+
+    std::vector<uint32_t> order;       // Edges in peel order
+    std::vector<uint8_t> order_pos;    // Which of the edge's vertices was free
+    order.reserve(n);
+    order_pos.reserve(n);
+
+    while (!stack.empty()) {
+        size_t v = stack.back();
+        stack.pop_back();
+
+        if (degree[v] != 1) continue;
+
+        uint32_t e = edge_xor[v];
+        size_t ev[3];
+        vertices(signatures[e], ev);
+
+        order.push_back(e);
+        order_pos.push_back(ev[0] == v ? 0 : (ev[1] == v ? 1 : 2));
+
+        for (size_t j = 0; j < 3; j++) {
+            size_t u = ev[j];
+            degree[u]--;
+            edge_xor[u] ^= e;
+            if (degree[u] == 1) stack.push_back(static_cast<uint32_t>(u));
+        }
+    }
+
+    if (order.size() != n) {
+        // Every edge left has all its vertices in the 2-core: none of them
+        // is ever a peeled key's free vertex, so they all stay unused
+        std::vector<bool> peeled(n, false);
+        for (uint32_t e : order) {
+            peeled[e] = true;
+        }
+        std::vector<uint64_t> core_signatures;
+        core_signatures.reserve(n - order.size());
+        for (size_t i = 0; i < n; i++) {
+            if (!peeled[i]) core_signatures.push_back(signatures[i]);
+        }
+
+        // Equal signatures share all vertices and sit in every 2-core
+        std::sort(core_signatures.begin(), core_signatures.end());
+        equal_signatures =
+            std::adjacent_find(core_signatures.begin(), core_signatures.end()) != core_signatures.end();
+        if (!divert_core || equal_signatures || !build_fallback(core_signatures, layout)) {
+            return false;  // Non-empty 2-core
+        }
+    }
+
+    // Free peeling state before allocating the g table
+    std::vector<uint8_t>().swap(degree);
+    std::vector<uint32_t>().swap(edge_xor);
+
+    // Assign g values in reverse peel order so each key's free vertex selects it
+    GLine unused_line;
+    std::fill(std::begin(unused_line.words), std::end(unused_line.words), ~0ULL);
+    g_lines.assign((table_size + VERTICES_PER_LINE - 1) / VERTICES_PER_LINE, unused_line);
+
+    for (size_t k = order.size(); k-- > 0;) {
+        size_t ev[3];
+        vertices(signatures[order[k]], ev);
+        unsigned j = order_pos[k];
+
+        // Unused vertices hold 3, which is 0 mod 3
+        unsigned sum = get_g(ev[(j + 1) % 3]) + get_g(ev[(j + 2) % 3]);
+        set_g(ev[j], static_cast<uint8_t>((j + 6 - sum % 3) % 3));
+    }
+
+    if (g_encoding == GEncoding::TERNARY) {
+        pack_ternary();
+        return true;
+    }
+
+    // Rank directory over used vertices
+    rank_samples.assign(g_lines.size(), 0);
+    uint32_t used = 0;
+    for (size_t l = 0; l < g_lines.size(); l++) {
+        rank_samples[l] = used;
+        for (uint64_t word : g_lines[l].words) {
+            used += VERTICES_PER_WORD - unused_fields(word, VERTICES_PER_WORD);
+        }
+    }
+
+    return true;
+}
+
+uint64_t BDZCore::lookup(uint64_t signature) const {
+    if (num_keys == 0) return NOT_FOUND;
+
+    size_t v[3];
+    vertices(signature, v);
+
+    if (g_encoding == GEncoding::TERNARY) {
+        return select_ternary(v);
+    }
+
+    // Rank samples of every candidate load alongside the g lines, so the
+    // selection adds no dependent miss
+    uint32_t samples[3];
+    for (size_t k = 0; k < 3; k++) {
+        samples[k] = rank_samples[v[k] / VERTICES_PER_LINE];
+    }
+
+    unsigned j = (get_g(v[0]) + get_g(v[1]) + get_g(v[2])) % 3;
+    size_t selected = v[j];
+    if (get_g(selected) == 3) {
+        return lookup_fallback(signature);
+    }
+    return samples[j] + rank_in_line(selected);
+}
+
+uint64_t BDZCore::lookup_fallback(uint64_t signature) const {
+    if (fallback.empty()) return NOT_FOUND;
+
+    uint64_t index = fallback.front().lookup(signature);
+    return index == NOT_FOUND ? NOT_FOUND : (num_keys - fallback.front().numKeys()) + index;
+}
+
+// Secondary table over the (distinct) 2-core signatures; its seeds derive
+// from this table's
+bool BDZCore::build_fallback(const std::vector<uint64_t>& core_signatures, Layout layout) {
+    fallback.resize(1);
+    for (int attempt = 0; attempt < FALLBACK_ATTEMPTS; attempt++) {
+        uint64_t fallback_seed = MurmurHash3::fmix64(seed + attempt + 1);
+        if (fallback.front().build(core_signatures.data(), core_signatures.size(), fallback_seed,
+                                   FALLBACK_TABLE_FACTOR, GEncoding::TWO_BIT, layout)) {
+            return true;
+        }
+    }
+    fallback.clear();
+    return false;
+}
+
+uint64_t BDZCore::select_ternary(const size_t v[3]) const {
+    unsigned sum = 0;
+    for (size_t k = 0; k < 3; k++) {
+        sum += TERNARY_TABLE.digits[g_trits[v[k] / VERTICES_PER_BYTE]][v[k] % VERTICES_PER_BYTE];
+    }
+    return v[sum % 3];
+}
+
+void BDZCore::lookupBatch(const uint64_t* signatures, size_t n, uint64_t* out) const {
+    size_t i = 0;
+#ifdef BDZ_CORE_SIMD
+    // Lanes multiply 32-bit hashes by 32-bit ranges
+    size_t range = vertex_layout == Layout::BLOCKED ? num_blocks : segment_size;
+    if (num_keys > 0 && range <= UINT32_MAX) {
+        for (; i + simd::LANES <= n; i += simd::LANES) {
+            lookup_group(signatures + i, out + i);
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = lookup(signatures[i]);
+    }
+}
+
+#ifdef BDZ_CORE_SIMD
+
+// vertices() and the g selection of lookup() for simd::LANES signatures.
+// TERNARY decodes the selected digits per lane, TWO_BIT ranks per lane.
+void BDZCore::lookup_group(const uint64_t* signatures, uint64_t* out) const {
+    using namespace simd;
+
+    vec a = fmix64(bit_xor(simd::load(signatures), set1(seed)));
+    vec b = fmix64(bit_xor(a, set1(0x9e3779b97f4a7c15ULL)));
+
+    vec v0, v1, v2;
+    if (vertex_layout == Layout::BLOCKED) {
+        constexpr size_t HALF = BLOCK_VERTICES / 2;
+        static_assert(BLOCK_VERTICES == 256, "Lane shifts assume 256-vertex blocks");
+        vec base = slli<8>(fastrange32(srli<32>(b), set1(num_blocks)));
+        v0 = add(base, srli<25>(bit_and(a, set1(0xFFFFFFFFULL))));  // fastrange32(a, HALF)
+        v1 = add(add(base, set1(HALF)), srli<57>(a));
+        vec other = slli<8>(fastrange32(b, set1(num_blocks - 1)));
+        vec skip = bit_andnot(gt(base, other), set1(BLOCK_VERTICES));
+        v2 = add(add(other, skip), bit_and(a, set1(BLOCK_VERTICES - 1)));
+    } else {
+        vec segment = set1(segment_size);
+        v0 = fastrange32(a, segment);
+        v1 = add(segment, fastrange32(srli<32>(a), segment));
+        v2 = add(set1(2 * segment_size), fastrange32(b, segment));
+    }
+
+    alignas(64) uint64_t lanes[3][LANES];
+    if (g_encoding == GEncoding::TERNARY) {
+        store(lanes[0], v0);
+        store(lanes[1], v1);
+        store(lanes[2], v2);
+        for (size_t i = 0; i < LANES; i++) {
+            size_t v[3] = {static_cast<size_t>(lanes[0][i]), static_cast<size_t>(lanes[1][i]),
+                           static_cast<size_t>(lanes[2][i])};
+            out[i] = select_ternary(v);
+        }
+        return;
+    }
+
+    // g value of each lane's vertex: word v / 32 of the flat line array
+    static_assert(sizeof(GLine) == WORDS_PER_LINE * sizeof(uint64_t), "Lines must be contiguous words");
+    const uint64_t* words = g_lines.data()->words;
+    vec mask2 = set1(3);
+    auto g_of = [&](vec v) {
+        vec word = gather(words, srli<5>(v));
+        return bit_and(srlv(word, slli<1>(bit_and(v, set1(VERTICES_PER_WORD - 1)))), mask2);
+    };
+    vec g0 = g_of(v0);
+    vec g1 = g_of(v1);
+    vec g2 = g_of(v2);
+
+    // (g0 + g1 + g2) mod 3; a sum of 9 (three unused vertices) leaves
+    // j = 3, which selects v0 like 9 mod 3 = 0
+    vec sum = add(add(g0, g1), g2);
+    vec j = sub(sum, bit_and(gt(sum, set1(2)), mask2));
+    j = sub(j, bit_and(gt(sum, set1(5)), mask2));
+    vec is1 = eq(j, set1(1));
+    vec is2 = eq(j, set1(2));
+    store(lanes[0], select(is2, v2, select(is1, v1, v0)));
+    store(lanes[1], select(is2, g2, select(is1, g1, g0)));
+
+    for (size_t i = 0; i < LANES; i++) {
+        out[i] = lanes[1][i] == 3 ? lookup_fallback(signatures[i]) : rank(static_cast<size_t>(lanes[0][i]));
+    }
+}
+
+#endif // BDZ_CORE_SIMD
+
+void BDZCore::prefetch(uint64_t signature) const {
+    if (num_keys == 0) return;
+
+    size_t v[3];
+    vertices(signature, v);
+    for (size_t vertex : v) {
+#ifdef _MSC_VER
+        (void)vertex;
+#else
+        if (g_encoding == GEncoding::TERNARY) {
+            __builtin_prefetch(&g_trits[vertex / VERTICES_PER_BYTE], 0, 1);
+        } else {
+            __builtin_prefetch(&g_lines[vertex / VERTICES_PER_LINE], 0, 1);
+            __builtin_prefetch(&rank_samples[vertex / VERTICES_PER_LINE], 0, 1);
+        }
+#endif
+    }
+}
+
+size_t BDZCore::sizeInBytes() const {
+    return sizeof(*this) + g_lines.size() * sizeof(GLine) + rank_samples.size() * sizeof(uint32_t) +
+           g_trits.size() + (fallback.empty() ? 0 : fallback.front().sizeInBytes());
+}
+
+void BDZCore::save(std::ostream& out) const {
+    io::write_pod<uint64_t>(out, num_keys);
+    io::write_pod<uint64_t>(out, table_size);
+    io::write_pod(out, seed);
+    io::write_pod(out, static_cast<uint8_t>(vertex_layout));
+    io::write_pod(out, static_cast<uint8_t>(g_encoding));
+    if (g_encoding == GEncoding::TERNARY) {
+        io::write_vector(out, g_trits);
+    } else {
+        io::write_vector(out, g_lines);
+        io::write_vector(out, rank_samples);
+        io::write_pod<uint8_t>(out, fallback.empty() ? 0 : 1);
+        if (!fallback.empty()) {
+            fallback.front().save(out);
+        }
+    }
+}
+
+void BDZCore::load(std::istream& in) {
+    num_keys = io::read_pod<uint64_t>(in);
+    uint64_t size = io::read_pod<uint64_t>(in);
+    seed = io::read_pod<uint64_t>(in);
+    uint8_t layout = io::read_pod<uint8_t>(in);
+    uint8_t encoding = io::read_pod<uint8_t>(in);
+
+    // Each key owns a vertex (the fallback's keys aside), in a table build()
+    // could have produced
+    if (size > UINT32_MAX || num_keys >= UINT32_MAX || (num_keys > 0 && size == 0) || num_keys > size) {
+        throw std::runtime_error("Corrupt BDZ table");
+    }
+    if (layout == static_cast<uint8_t>(Layout::BLOCKED)) {
+        if (size % BLOCK_VERTICES != 0 || (num_keys > 0 && size < 2 * BLOCK_VERTICES)) {
+            throw std::runtime_error("Corrupt BDZ table");
+        }
+        vertex_layout = Layout::BLOCKED;
+    } else if (layout == static_cast<uint8_t>(Layout::UNIFORM)) {
+        if (size % 3 != 0) {
+            throw std::runtime_error("Corrupt BDZ table");
+        }
+        vertex_layout = Layout::UNIFORM;
+    } else {
+        throw std::runtime_error("Unknown BDZ vertex layout");
+    }
+    set_table_size(size);
+    g_lines.clear();
+    rank_samples.clear();
+    g_trits.clear();
+    fallback.clear();
+
+    if (encoding == static_cast<uint8_t>(GEncoding::TERNARY)) {
+        g_encoding = GEncoding::TERNARY;
+        io::read_vector(in, g_trits);
+        if (g_trits.size() != (table_size + VERTICES_PER_BYTE - 1) / VERTICES_PER_BYTE) {
+            throw std::runtime_error("Corrupt BDZ table");
+        }
+    } else if (encoding == static_cast<uint8_t>(GEncoding::TWO_BIT)) {
+        g_encoding = GEncoding::TWO_BIT;
+        io::read_vector(in, g_lines);
+        io::read_vector(in, rank_samples);
+        if (g_lines.size() != (table_size + VERTICES_PER_LINE - 1) / VERTICES_PER_LINE ||
+            rank_samples.size() != g_lines.size()) {
+            throw std::runtime_error("Corrupt BDZ table");
+        }
+        if (io::read_pod<uint8_t>(in) != 0) {
+            fallback.resize(1);
+            fallback.front().load(in);
+            const BDZCore& secondary = fallback.front();
+            // One level only: the secondary table is built without a fallback
+            if (secondary.numKeys() > num_keys || secondary.encoding() != GEncoding::TWO_BIT ||
+                !secondary.fallback.empty()) {
+                throw std::runtime_error("Corrupt BDZ fallback table");
+            }
+        }
+
+        // Rank samples must count the used vertices before each line, and
+        // the primary table must use one vertex per key it holds
+        size_t primary_keys = num_keys - (fallback.empty() ? 0 : fallback.front().numKeys());
+        uint64_t used = 0;
+        for (size_t l = 0; l < g_lines.size(); l++) {
+            if (rank_samples[l] != used) {
+                throw std::runtime_error("Corrupt BDZ table");
+            }
+            for (uint64_t word : g_lines[l].words) {
+                used += VERTICES_PER_WORD - unused_fields(word, VERTICES_PER_WORD);
+            }
+        }
+        if (used != primary_keys) {
+            throw std::runtime_error("Corrupt BDZ table");
+        }
+    } else {
+        throw std::runtime_error("Unknown BDZ g encoding");
+    }
+}
+
+} // namespace hashing
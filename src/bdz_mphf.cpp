@@ -1,17 +1,24 @@
 #include "bdz_mphf.hpp"
 #include "murmur_hash.hpp"
+#include "duplicate_keys.hpp"
+#include "hash_util.hpp"
 #include <random>
 #include <queue>
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstring>
 
 namespace hashing {
 
 void BDZ_MPHF::compute_three_hashes(const std::string& key, size_t& h0, size_t& h1, size_t& h2) const {
-    // Use MurmurHash3 for high-quality, independent hash functions
-    MurmurHash3::hash_triple(key, seeds[0], seeds[1], seeds[2], h0, h1, h2, table_size);
+    // MurmurHash3 with one seed per vertex, each into its own third of the table
+    size_t third = table_size / 3;
+    h0 = MurmurHash3::hash64(key, seeds[0]) % third;
+    h1 = third + MurmurHash3::hash64(key, seeds[1]) % third;
+    h2 = 2 * third + MurmurHash3::hash64(key, seeds[2]) % third;
 }
 
 uint8_t BDZ_MPHF::get_g_value(size_t index) const {
@@ -27,6 +34,22 @@ void BDZ_MPHF::set_g_value(size_t index, uint8_t value) {
     g_values[byte_idx] |= (value & 0x03) << bit_offset;
 }
 
+// Used vertices (g != 3) before the given one: the block's sample plus the
+// used fields of its 64-bit words up to the vertex
+uint64_t BDZ_MPHF::rank(size_t vertex) const {
+    const uint8_t* block = g_values.data() + vertex / VERTICES_PER_BLOCK * (VERTICES_PER_BLOCK / 4);
+    size_t fields = vertex % VERTICES_PER_BLOCK;
+    uint64_t r = rank_samples[vertex / VERTICES_PER_BLOCK] + fields;
+    for (size_t word = 0; word * 32 < fields; word++) {
+        uint64_t w;
+        std::memcpy(&w, block + word * 8, sizeof(w));
+        uint64_t unused = w & (w >> 1) & 0x5555555555555555ULL;
+        if (fields - word * 32 < 32) unused &= (1ULL << ((fields - word * 32) * 2)) - 1;
+        r -= popcount64(unused);
+    }
+    return r;
+}
+
 bool BDZ_MPHF::build_graph_and_assign(const std::vector<std::string>& keys) {
     // Build 3-uniform hypergraph
     std::vector<std::vector<size_t>> edges(table_size);
@@ -55,7 +78,7 @@ bool BDZ_MPHF::build_graph_and_assign(const std::vector<std::string>& keys) {
     }
     
     std::vector<bool> visited_keys(num_keys, false);
-    std::vector<size_t> ordering;
+    std::vector<std::pair<size_t, size_t>> ordering;  // (key, vertex it was peeled at)
     
     while (!queue.empty()) {
         size_t v = queue.front();
@@ -64,7 +87,7 @@ bool BDZ_MPHF::build_graph_and_assign(const std::vector<std::string>& keys) {
         if (degree[v] == 0) continue;
         
         // Find the unvisited key
-        size_t key_idx = table_size;
+        size_t key_idx = num_keys;
         for (size_t k : edges[v]) {
             if (!visited_keys[k]) {
                 key_idx = k;
@@ -72,10 +95,10 @@ bool BDZ_MPHF::build_graph_and_assign(const std::vector<std::string>& keys) {
             }
         }
         
-        if (key_idx == table_size) continue;
+        if (key_idx == num_keys) continue;
         
         visited_keys[key_idx] = true;
-        ordering.push_back(key_idx);
+        ordering.emplace_back(key_idx, v);
         
         // Update degrees
         for (size_t j = 0; j < 3; j++) {
@@ -92,76 +115,40 @@ bool BDZ_MPHF::build_graph_and_assign(const std::vector<std::string>& keys) {
         return false;  // Graph has cycles
     }
     
-    // Assign g values in reverse order
-    std::vector<int> assigned_values(table_size, -1);
-    
+    // Assign g values in reverse order: a key's peel vertex is still unused
+    // (3, which counts as 0 mod 3) and gets the value that makes the sum
+    // select it
     for (auto it = ordering.rbegin(); it != ordering.rend(); ++it) {
-        size_t key_idx = *it;
-        auto& edge = key_edges[key_idx];
-        
-        // Find which g-value to assign
-        for (uint8_t g = 0; g < 3; g++) {
-            size_t sum = 0;
-            bool valid = true;
-            
-            for (size_t j = 0; j < 3; j++) {
-                size_t v = edge[j];
-                if (assigned_values[v] == -1) {
-                    assigned_values[v] = g;
-                    sum += g;
-                    break;
-                } else {
-                    sum += assigned_values[v];
-                }
-            }
-            
-            if ((sum % 3) == (key_idx % 3)) {
-                break;
-            }
+        const auto& edge = key_edges[it->first];
+        size_t selected = it->second == edge[0] ? 0 : it->second == edge[1] ? 1 : 2;
+        unsigned sum = 0;
+        for (size_t j = 0; j < 3; j++) {
+            if (j != selected) sum += get_g_value(edge[j]);
         }
+        set_g_value(it->second, static_cast<uint8_t>((selected + 6 - sum % 3) % 3));
     }
-    
-    // Store g-values
+
+    uint64_t used = 0;
     for (size_t v = 0; v < table_size; v++) {
-        if (assigned_values[v] != -1) {
-            set_g_value(v, assigned_values[v]);
-        }
+        if (v % VERTICES_PER_BLOCK == 0) rank_samples[v / VERTICES_PER_BLOCK] = used;
+        if (get_g_value(v) != 3) used++;
     }
     
     return true;
 }
 
-double BDZ_MPHF::compute_chi_square(const std::vector<std::string>& keys) const {
-    // Compute chi-square statistic for hash distribution quality
-    // Tests if hash values are uniformly distributed across buckets
-    std::vector<size_t> bucket_counts(num_keys, 0);
-
-    for (const auto& key : keys) {
-        uint64_t h = hash(key);
-        if (h < num_keys) {
-            bucket_counts[h]++;
-        }
-    }
-
-    double expected = static_cast<double>(keys.size()) / num_keys;
-    double chi_square = 0.0;
-
-    for (size_t count : bucket_counts) {
-        double diff = count - expected;
-        chi_square += (diff * diff) / expected;
-    }
-
-    return chi_square;
-}
-
 void BDZ_MPHF::build(const std::vector<std::string>& keys) {
     num_keys = keys.size();
-    table_size = static_cast<size_t>(1.23 * num_keys);  // BDZ requires ~1.23n space
+    // BDZ requires ~1.23n space, split into three equal ranges; tiny sets
+    // get a few spare vertices so two keys rarely share all three
+    size_t third = static_cast<size_t>(std::ceil(build_config.table_factor * num_keys / 3));
+    table_size = 3 * std::max<size_t>(8, third);
 
-    g_values.resize((table_size + 3) / 4, 0);
+    size_t num_blocks = (table_size + VERTICES_PER_BLOCK - 1) / VERTICES_PER_BLOCK;
+    g_values.assign(num_blocks * VERTICES_PER_BLOCK / 4, 0);
+    rank_samples.assign(num_blocks, 0);
 
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
+    std::mt19937_64 gen = build_rng();
 
     construction_stats = ConstructionStats();
     bool success = false;
@@ -172,47 +159,55 @@ void BDZ_MPHF::build(const std::vector<std::string>& keys) {
         seeds[1] = gen();
         seeds[2] = gen();
 
-        std::fill(g_values.begin(), g_values.end(), 0);
+        std::fill(g_values.begin(), g_values.end(), 0xFF);  // All vertices unused
         success = build_graph_and_assign(keys);
+
+        // Repeated keys fail every attempt; look for them once, after the first failure
+        if (!success && attempt == 0) {
+            std::vector<size_t> repeats = findDuplicateKeys(keys, build_config.num_threads);
+            if (!repeats.empty()) {
+                if (build_config.deduplicate) {
+                    std::vector<std::string> distinct = keys;
+                    eraseDuplicates(distinct, repeats);
+                    build(distinct);
+                    construction_stats.attempts++;
+                }
+                reportDuplicates(construction_stats, repeats, getName(), build_config.deduplicate);
+                return;
+            }
+        }
     }
 
     construction_stats.success = success;
 
     if (!success) {
         std::cerr << "Warning: BDZ MPHF construction failed after 100 attempts\n";
-    } else {
-        // Compute chi-square statistic for the successful build
-        construction_stats.chi_square = compute_chi_square(keys);
     }
 }
 
 uint64_t BDZ_MPHF::hash(const std::string& key) const {
-    size_t h0, h1, h2;
-    compute_three_hashes(key, h0, h1, h2);
+    size_t h[3];
+    compute_three_hashes(key, h[0], h[1], h[2]);
     
-    uint8_t g0 = get_g_value(h0);
-    uint8_t g1 = get_g_value(h1);
-    uint8_t g2 = get_g_value(h2);
+    uint8_t g0 = get_g_value(h[0]);
+    uint8_t g1 = get_g_value(h[1]);
+    uint8_t g2 = get_g_value(h[2]);
     
-    return (g0 + g1 + g2) % num_keys;
+    return rank(h[(g0 + g1 + g2) % 3]);
 }
 
 size_t BDZ_MPHF::getMemoryUsage() const {
-    return sizeof(*this) + g_values.capacity();
+    return sizeof(*this) + g_values.capacity() + rank_samples.capacity() * sizeof(uint64_t);
 }
 
 void BDZ_MPHF::printStats() const {
     std::cout << "  Table size: " << table_size << " (" << (double)table_size / num_keys << "x keys)\n";
-    std::cout << "  Memory: " << g_values.size() << " bytes ("
-              << (g_values.size() * 8.0 / num_keys) << " bits/key)\n";
+    size_t bytes = g_values.size() + rank_samples.size() * sizeof(uint64_t);
+    std::cout << "  Memory: " << bytes << " bytes (" << (bytes * 8.0 / num_keys) << " bits/key)\n";
     std::cout << "  Theoretical minimum: ~1.44 bits/key\n";
 
     if (construction_stats.success) {
         std::cout << "  Construction attempts: " << construction_stats.attempts << "\n";
-        std::cout << "  Chi-square statistic: " << std::fixed << std::setprecision(2)
-                  << construction_stats.chi_square << " (lower is better)\n";
-        // For reference: expected chi-square for uniform distribution is approximately (buckets - 1)
-        std::cout << "  Expected χ² for uniform: ~" << (num_keys - 1) << "\n";
     }
 }
 
@@ -0,0 +1,209 @@
+#include "cuckoo_perfect_hash.hpp"
+#include "duplicate_keys.hpp"
+#include "murmur_hash.hpp"
+#include "serialization.hpp"
+#include <random>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace hashing {
+
+uint64_t CuckooPerfectHash::key_hash(const char* data, size_t len) const {
+    return MurmurHash3::hash64_bytes(data, len, seed);
+}
+
+CuckooPerfectHash::RecordHeader CuckooPerfectHash::record_at(uint32_t offset) const {
+    RecordHeader header;
+    std::memcpy(&header, arena.data() + offset, sizeof(header));
+    return header;
+}
+
+// Arena offset of the key's record, or NOT_FOUND
+uint64_t CuckooPerfectHash::find(const char* data, size_t len, uint64_t h) const {
+    return table.find(h, [&](uint32_t offset) {
+        return record_at(offset).length == len &&
+               std::memcmp(arena.data() + offset + sizeof(RecordHeader), data, len) == 0;
+    });
+}
+
+// Returns the new record's arena offset
+uint32_t CuckooPerfectHash::append_key(const std::string& key) {
+    size_t offset = arena.size();
+    if (offset + sizeof(RecordHeader) + key.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("Cuckoo Perfect Hash is limited to 4 GiB of keys");
+    }
+    RecordHeader header{static_cast<uint32_t>(key.size()), static_cast<uint32_t>(num_keys)};
+    const char* bytes = reinterpret_cast<const char*>(&header);
+    arena.insert(arena.end(), bytes, bytes + sizeof(header));
+    arena.insert(arena.end(), key.begin(), key.end());
+    num_keys++;
+    return static_cast<uint32_t>(offset);
+}
+
+// Reinsert every arena key into a fresh table; false when a key finds no
+// slot or repeats an earlier one
+bool CuckooPerfectHash::rebuild(size_t num_buckets, uint64_t new_seed) {
+    table.reset(num_buckets);
+    seed = new_seed;
+
+    for (size_t offset = 0; offset < arena.size();) {
+        size_t len = record_at(static_cast<uint32_t>(offset)).length;
+        const char* data = arena.data() + offset + sizeof(RecordHeader);
+        uint64_t h = key_hash(data, len);
+        if (find(data, len, h) != CuckooTable::NOT_FOUND || !table.insert(h, static_cast<uint32_t>(offset))) {
+            return false;
+        }
+        offset += sizeof(RecordHeader) + len;
+    }
+    return true;
+}
+
+// Drop the table and its keys together, so a later insert() starts empty
+void CuckooPerfectHash::clear() {
+    table.reset(0);
+    arena.clear();
+    num_keys = 0;
+}
+
+void CuckooPerfectHash::build(const std::vector<std::string>& keys) {
+    construction_stats = ConstructionStats();
+    clear();
+
+    size_t total_bytes = 0;
+    for (const auto& key : keys) total_bytes += sizeof(RecordHeader) + key.size();
+    arena.reserve(total_bytes);
+    for (const auto& key : keys) append_key(key);
+
+    std::mt19937_64 gen = build_rng();
+    if (num_keys == 0) {
+        seed = gen();
+        construction_stats.success = true;
+        return;
+    }
+
+    double num_buckets = std::ceil(num_keys / (CuckooTable::SLOTS_PER_BUCKET * TARGET_LOAD));
+    for (int attempt = 0; attempt < MAX_BUILD_ATTEMPTS; attempt++) {
+        construction_stats.attempts++;
+        if (rebuild(static_cast<size_t>(num_buckets), gen())) {
+            construction_stats.success = true;
+            return;
+        }
+
+        // Repeated keys fail every attempt; look for them once, after the first failure
+        if (attempt == 0) {
+            std::vector<size_t> repeats = findDuplicateKeys(keys, build_config.num_threads);
+            if (!repeats.empty()) {
+                if (build_config.deduplicate) {
+                    std::vector<std::string> distinct = keys;
+                    eraseDuplicates(distinct, repeats);
+                    build(distinct);
+                    construction_stats.attempts++;
+                } else {
+                    clear();
+                }
+                reportDuplicates(construction_stats, repeats, getName(), build_config.deduplicate);
+                return;
+            }
+        }
+        num_buckets *= BUILD_GROWTH;
+    }
+
+    std::cerr << "Warning: " << getName() << " construction failed after "
+              << construction_stats.attempts << " attempts\n";
+    clear();
+}
+
+uint64_t CuckooPerfectHash::insert(const std::string& key) {
+    if (table.numBuckets() == 0) {
+        table.reset(1);
+    }
+
+    uint64_t h = key_hash(key.data(), key.size());
+    uint64_t existing = find(key.data(), key.size(), h);
+    if (existing != CuckooTable::NOT_FOUND) {
+        return record_at(static_cast<uint32_t>(existing)).index;
+    }
+
+    uint32_t offset = append_key(key);
+    uint64_t id = num_keys - 1;
+    if (table.insert(h, offset)) return id;
+
+    // No reachable free slot: grow (keeping the seed) until all keys fit
+    size_t num_buckets = table.numBuckets();
+    do {
+        num_buckets = static_cast<size_t>(num_buckets * INSERT_GROWTH) + 1;
+    } while (!rebuild(num_buckets, seed));
+    return id;
+}
+
+uint64_t CuckooPerfectHash::hash(const std::string& key) const {
+    uint64_t offset = find(key.data(), key.size(), key_hash(key.data(), key.size()));
+    if (offset == CuckooTable::NOT_FOUND) return UINT64_MAX;
+    return record_at(static_cast<uint32_t>(offset)).index;
+}
+
+double CuckooPerfectHash::loadFactor() const {
+    if (table.capacity() == 0) return 0.0;
+    return static_cast<double>(num_keys) / table.capacity();
+}
+
+size_t CuckooPerfectHash::getMemoryUsage() const {
+    return sizeof(*this) + table.sizeInBytes() + arena.size();
+}
+
+void CuckooPerfectHash::printStats() const {
+    std::cout << "  Buckets: " << table.numBuckets() << " x " << CuckooTable::SLOTS_PER_BUCKET << " slots\n";
+    std::cout << "  Load factor: " << std::fixed << std::setprecision(3) << loadFactor() << "\n";
+    std::cout << "  Key arena: " << arena.size() << " bytes\n";
+    if (num_keys > 0) {
+        std::cout << "  Index bits/key (excl. keys): " << std::setprecision(2)
+                  << (table.sizeInBytes() * 8.0 / num_keys) << "\n";
+    }
+    std::cout << "  Construction attempts: " << construction_stats.attempts << "\n";
+}
+
+void CuckooPerfectHash::save(std::ostream& out) const {
+    io::write_pod<uint64_t>(out, seed);
+    io::write_pod<uint64_t>(out, num_keys);
+    table.save(out);
+    io::write_vector(out, arena);
+}
+
+void CuckooPerfectHash::load(std::istream& in) {
+    seed = io::read_pod<uint64_t>(in);
+    num_keys = io::read_pod<uint64_t>(in);
+    table.load(in);
+    io::read_vector(in, arena);
+
+    // Records must tile the arena and be numbered in order
+    std::vector<uint32_t> starts;
+    size_t offset = 0;
+    while (offset + sizeof(RecordHeader) <= arena.size()) {
+        RecordHeader header = record_at(static_cast<uint32_t>(offset));
+        if (header.index != starts.size() || header.length > arena.size() - offset - sizeof(RecordHeader)) break;
+        starts.push_back(static_cast<uint32_t>(offset));
+        offset += sizeof(RecordHeader) + header.length;
+    }
+    bool valid = offset == arena.size() && starts.size() == num_keys && (num_keys == 0 || table.numBuckets() > 0);
+
+    // and every occupied slot must hold the start of its own record
+    std::vector<uint8_t> referenced(starts.size(), 0);
+    size_t occupied = 0;
+    table.forEachValue([&](uint32_t value) {
+        auto it = std::lower_bound(starts.begin(), starts.end(), value);
+        if (it == starts.end() || *it != value || referenced[it - starts.begin()]++) valid = false;
+        occupied++;
+    });
+    if (!valid || occupied != num_keys) {
+        throw std::runtime_error("Corrupt " + getName() + " index");
+    }
+    construction_stats = ConstructionStats();
+    construction_stats.success = true;
+}
+
+} // namespace hashing
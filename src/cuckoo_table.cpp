@@ -0,0 +1,89 @@
+#include "cuckoo_table.hpp"
+#include "serialization.hpp"
+#include <stdexcept>
+
+namespace hashing {
+
+void CuckooTable::reset(size_t num_buckets) {
+    buckets.assign(num_buckets, Bucket{});
+}
+
+// Breadth-first search from both candidate buckets for the nearest free
+// slot, then shift entries along the path from its end. Each move takes an
+// entry to its other bucket; if an earlier move already changed a slot the
+// path relies on, stop there (the table stays valid) and search again.
+bool CuckooTable::try_insert(uint64_t h, uint32_t value, bool& path_stale) {
+    struct Node {
+        uint32_t bucket;
+        int32_t parent;  // -1 for the two candidate buckets
+        uint8_t slot;    // Slot in the parent bucket whose entry moves here
+    };
+
+    uint16_t tag = tag_of(h);
+    size_t b1 = primary_bucket(h);
+    size_t b2 = alternate_bucket(b1, tag);
+
+    std::vector<Node> nodes;
+    nodes.reserve(MAX_BFS_NODES);
+    nodes.push_back({static_cast<uint32_t>(b1), -1, 0});
+    if (b2 != b1) nodes.push_back({static_cast<uint32_t>(b2), -1, 0});
+
+    path_stale = false;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const Bucket& bucket = buckets[nodes[i].bucket];
+        uint32_t free_mask = tag_matches(bucket, EMPTY_TAG);
+
+        if (free_mask) {
+            size_t cur = i;
+            size_t target = lowest_bit(free_mask);
+            while (nodes[cur].parent >= 0) {
+                const Node& node = nodes[cur];
+                size_t from_bucket = nodes[node.parent].bucket;
+                Bucket& from = buckets[from_bucket];
+                Bucket& to = buckets[node.bucket];
+                uint16_t moved = from.tags[node.slot];
+                if (moved == EMPTY_TAG || alternate_bucket(from_bucket, moved) != node.bucket) {
+                    path_stale = true;
+                    return false;
+                }
+                to.tags[target] = moved;
+                to.values[target] = from.values[node.slot];
+                from.tags[node.slot] = EMPTY_TAG;
+                target = node.slot;
+                cur = node.parent;
+            }
+            Bucket& home = buckets[nodes[cur].bucket];
+            home.tags[target] = tag;
+            home.values[target] = value;
+            return true;
+        }
+
+        for (size_t s = 0; s < SLOTS_PER_BUCKET && nodes.size() < MAX_BFS_NODES; s++) {
+            size_t next = alternate_bucket(nodes[i].bucket, bucket.tags[s]);
+            if (next == nodes[i].bucket) continue;
+            nodes.push_back({static_cast<uint32_t>(next), static_cast<int32_t>(i), static_cast<uint8_t>(s)});
+        }
+    }
+    return false;
+}
+
+bool CuckooTable::insert(uint64_t h, uint32_t value) {
+    if (buckets.empty()) return false;
+
+    bool path_stale = false;
+    for (int attempt = 0; attempt < MAX_INSERT_ATTEMPTS; attempt++) {
+        if (try_insert(h, value, path_stale)) return true;
+        if (!path_stale) return false;
+    }
+    return false;
+}
+
+void CuckooTable::save(std::ostream& out) const {
+    io::write_vector(out, buckets);
+}
+
+void CuckooTable::load(std::istream& in) {
+    io::read_vector(in, buckets);
+}
+
+} // namespace hashing
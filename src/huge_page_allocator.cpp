@@ -0,0 +1,112 @@
+#include "huge_page_allocator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#ifdef __linux__
+    #include <sys/mman.h>
+#endif
+
+namespace hashing {
+
+namespace {
+
+std::atomic<HugePages> policy{HugePages::TRANSPARENT};
+std::atomic<size_t> mapped_bytes{0};
+
+// Ranges from the MAP_HUGETLB pool; large arrays are few, a list will do
+std::mutex explicit_mutex;
+std::vector<void*> explicit_ranges;
+size_t explicit_bytes = 0;
+
+size_t round_up(size_t bytes, size_t unit) {
+    return (bytes + unit - 1) / unit * unit;
+}
+
+} // namespace
+
+void setHugePages(HugePages new_policy) { policy.store(new_policy); }
+HugePages hugePages() { return policy.load(); }
+
+size_t hugePageMappedBytes() { return mapped_bytes.load(); }
+size_t hugePageExplicitBytes() {
+    std::lock_guard<std::mutex> lock(explicit_mutex);
+    return explicit_bytes;
+}
+
+namespace detail {
+
+#ifdef __linux__
+
+// Whole 2 MB units, so MAP_HUGETLB and anonymous mappings unmap the same way
+void* map_pages(size_t bytes) {
+    size_t len = round_up(bytes, HUGE_PAGE_SIZE);
+    HugePages mode = policy.load();
+
+    if (mode == HugePages::EXPLICIT) {
+        void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            std::lock_guard<std::mutex> lock(explicit_mutex);
+            explicit_ranges.push_back(p);
+            explicit_bytes += len;
+            mapped_bytes += len;
+            return p;
+        }
+        // Pool empty or not configured: fall back to transparent huge pages
+        mode = HugePages::TRANSPARENT;
+    }
+
+    // Over-map by one huge page and trim, so the range starts on a 2 MB
+    // boundary and every huge page in it is eligible for THP
+    size_t span = len + HUGE_PAGE_SIZE;
+    void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = round_up(start, HUGE_PAGE_SIZE);
+    if (aligned > start) {
+        munmap(raw, aligned - start);
+    }
+    size_t tail = (start + span) - (aligned + len);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + len), tail);
+    }
+
+    void* p = reinterpret_cast<void*>(aligned);
+    madvise(p, len, mode == HugePages::OFF ? MADV_NOHUGEPAGE : MADV_HUGEPAGE);
+    mapped_bytes += len;
+    return p;
+}
+
+void unmap_pages(void* p, size_t bytes) noexcept {
+    size_t len = round_up(bytes, HUGE_PAGE_SIZE);
+    {
+        std::lock_guard<std::mutex> lock(explicit_mutex);
+        auto it = std::find(explicit_ranges.begin(), explicit_ranges.end(), p);
+        if (it != explicit_ranges.end()) {
+            explicit_ranges.erase(it);
+            explicit_bytes -= len;
+        }
+    }
+    munmap(p, len);
+    mapped_bytes -= len;
+}
+
+#else
+
+// No huge page interface: plain cache-line aligned heap blocks
+void* map_pages(size_t bytes) {
+    return ::operator new(bytes, std::align_val_t(64));
+}
+
+void unmap_pages(void* p, size_t) noexcept {
+    ::operator delete(p, std::align_val_t(64));
+}
+
+#endif
+
+} // namespace detail
+
+} // namespace hashing
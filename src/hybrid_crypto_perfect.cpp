@@ -0,0 +1,25 @@
+#include "hybrid_crypto_perfect.hpp"
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+namespace hashing {
+
+void HybridCryptoPerfect::printStats() const {
+    const FingerprintArray& codes = verifier.fingerprints();
+
+    std::cout << "  Architecture: SipHash-2-4 + BDZ-MPHF + Signature Codes\n";
+    std::cout << "  MPHF Space: " << mphf.sizeInBytes() << " bytes\n";
+    std::cout << "  Verification codes: " << codes.sizeInBytes() << " bytes ("
+              << codes.width() << " bits each)\n";
+    std::cout << "  False positive rate: 2^-" << codes.width() << " ("
+              << std::scientific << std::setprecision(2) << std::ldexp(1.0, -static_cast<int>(codes.width()))
+              << std::fixed << ")\n";
+    printKeyStoreStats();
+
+    if (construction_stats.success) {
+        std::cout << "  Construction attempts: " << construction_stats.attempts << "\n";
+    }
+}
+
+} // namespace hashing
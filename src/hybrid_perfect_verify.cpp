@@ -0,0 +1,213 @@
+#include "hybrid_perfect_verify.hpp"
+#include "serialization.hpp"
+#include "duplicate_keys.hpp"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace hashing {
+
+// Index of the key with this SipHash value and BLAKE3 code, or NOT_FOUND
+uint64_t HybridPerfectVerify::find(uint64_t preprocessed, uint64_t code) const {
+    return table.find(preprocessed, [&](uint32_t index) { return codes.matches(index, code); });
+}
+
+// Same, computing the BLAKE3 code only if some tag matches
+uint64_t HybridPerfectVerify::find_key(const std::string& key, uint64_t preprocessed) const {
+    uint64_t code = 0;
+    bool have_code = false;
+    return table.find(preprocessed, [&](uint32_t index) {
+        if (!have_code) {
+            code = blake3_fingerprint(key);
+            have_code = true;
+        }
+        return codes.matches(index, code);
+    });
+}
+
+KeySignatures HybridPerfectVerify::hash_keys(const std::vector<std::string>& keys, std::mt19937_64& gen) {
+    preprocessor.reseed(gen, build_config.key_hash);
+    return compute_signatures(keys, build_config.num_threads,
+        [this](const std::string& key) { return preprocessor(key); },
+        [](const std::string& key) { return blake3_fingerprint(key); });
+}
+
+void HybridPerfectVerify::build_from_signatures(KeySignatures& sigs) {
+    construction_stats = ConstructionStats();
+
+    // The table keeps only a tag and a short code per key, too little to
+    // tell keys apart; repeats are found on the 128-bit (SipHash, BLAKE3)
+    // signatures before anything is inserted
+    std::vector<size_t> repeats = findDuplicateSignatures(sigs, build_config.num_threads);
+    if (!repeats.empty()) {
+        reportDuplicates(construction_stats, repeats, getName(), build_config.deduplicate);
+        if (!build_config.deduplicate) {
+            num_keys = 0;
+            table.reset(0);
+            return;
+        }
+        eraseDuplicates(sigs.index_hashes, repeats);
+        eraseDuplicates(sigs.fingerprints, repeats);
+    }
+
+    num_keys = sigs.size();
+    if (num_keys >= std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error(getName() + " supports fewer than 2^32 keys");
+    }
+
+    codes.reset(num_keys, build_config.fingerprint_bits ? build_config.fingerprint_bits
+                                                        : DEFAULT_CODE_BITS);
+    for (size_t i = 0; i < num_keys; i++) {
+        codes.set(i, sigs.fingerprints[i]);
+    }
+
+    // Slots per key from the configured table factor, at most MAX_LOAD full
+    double slots_per_key = std::max(build_config.table_factor, 1.0 / MAX_LOAD);
+    double num_buckets = std::max(1.0, std::ceil(num_keys * slots_per_key / CuckooTable::SLOTS_PER_BUCKET));
+
+    // Keys are not rehashed on retry: a failed attempt only grows the table
+    for (int attempt = 0; attempt < MAX_BUILD_ATTEMPTS; attempt++) {
+        construction_stats.attempts++;
+        table.reset(static_cast<size_t>(num_buckets));
+
+        size_t placed = 0;
+        for (; placed < num_keys; placed++) {
+            if (!table.insert(sigs.index_hashes[placed], static_cast<uint32_t>(placed))) break;
+        }
+        if (placed == num_keys) {
+            construction_stats.success = true;
+            return;
+        }
+        num_buckets *= BUILD_GROWTH;
+    }
+
+    std::cerr << "Warning: " << getName() << " construction failed after "
+              << construction_stats.attempts << " attempts\n";
+    table.reset(0);
+}
+
+void HybridPerfectVerify::build(const std::vector<std::string>& keys) {
+    std::mt19937_64 gen = build_rng();
+
+    KeySignatures sigs = hash_keys(keys, gen);
+    build_from_signatures(sigs);
+}
+
+void HybridPerfectVerify::buildAndRelease(std::vector<std::string>&& keys) {
+    std::mt19937_64 gen = build_rng();
+
+    KeySignatures sigs = hash_keys(keys, gen);
+    std::vector<std::string>().swap(keys);
+    build_from_signatures(sigs);
+}
+
+uint64_t HybridPerfectVerify::hash(const std::string& key) const {
+    return find_key(key, preprocessor(key));
+}
+
+// Three passes per group: hash and prefetch buckets, prefetch the codes of
+// tag matches, then verify. Both dependent misses overlap across the group.
+void HybridPerfectVerify::hashBatch(const std::string* keys, size_t n, uint64_t* out) const {
+    uint64_t preprocessed[BATCH_SIZE];
+    for (size_t begin = 0; begin < n; begin += BATCH_SIZE) {
+        size_t count = std::min(BATCH_SIZE, n - begin);
+        for (size_t i = 0; i < count; i++) {
+            preprocessed[i] = preprocessor(keys[begin + i]);
+            table.prefetch(preprocessed[i]);
+        }
+        for (size_t i = 0; i < count; i++) {
+            table.find(preprocessed[i], [&](uint32_t index) {
+                prefetch_read(codes.locate(index));
+                return false;
+            });
+        }
+        for (size_t i = 0; i < count; i++) {
+            out[begin + i] = find_key(keys[begin + i], preprocessed[i]);
+        }
+    }
+}
+
+#ifdef HASHING_COROUTINES
+LookupTask HybridPerfectVerify::hashCoroutine(const std::string& key) const {
+    uint64_t preprocessed = preprocessor(key);
+    table.prefetch(preprocessed);
+    co_await PrefetchSuspend{};
+
+    bool tag_matched = false;
+    table.find(preprocessed, [&](uint32_t index) {
+        prefetch_read(codes.locate(index));
+        tag_matched = true;
+        return false;
+    });
+    if (!tag_matched) {
+        co_return UINT64_MAX;
+    }
+    co_await PrefetchSuspend{};
+
+    co_return find_key(key, preprocessed);
+}
+#endif
+
+uint64_t HybridPerfectVerify::insert(const std::string& key) {
+    uint64_t h = preprocessor(key);
+    uint64_t code = blake3_fingerprint(key);
+    uint64_t existing = find(h, code);
+    if (existing != CuckooTable::NOT_FOUND) return existing;
+
+    if (num_keys + 1 >= std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error(getName() + " supports fewer than 2^32 keys");
+    }
+    uint32_t index = static_cast<uint32_t>(num_keys);
+    if (!table.insert(h, index)) {
+        throw std::length_error(getName() + " is full; rebuild with a larger table factor");
+    }
+    codes.resize(num_keys + 1);
+    codes.set(index, code);
+    num_keys++;
+    return index;
+}
+
+double HybridPerfectVerify::loadFactor() const {
+    if (table.capacity() == 0) return 0.0;
+    return static_cast<double>(num_keys) / table.capacity();
+}
+
+size_t HybridPerfectVerify::getMemoryUsage() const {
+    return sizeof(*this) + table.sizeInBytes() + codes.sizeInBytes();
+}
+
+void HybridPerfectVerify::printStats() const {
+    std::cout << "  Architecture: SipHash-2-4 + Cuckoo Index + BLAKE3 Codes\n";
+    std::cout << "  Cuckoo table: " << table.numBuckets() << " x " << CuckooTable::SLOTS_PER_BUCKET
+              << " slots (" << table.sizeInBytes() << " bytes)\n";
+    std::cout << "  Load factor: " << std::fixed << std::setprecision(3) << loadFactor() << "\n";
+    std::cout << "  Verification codes: " << codes.sizeInBytes() << " bytes ("
+              << codes.width() << " bits each)\n";
+    if (construction_stats.success) {
+        std::cout << "  Construction attempts: " << construction_stats.attempts << "\n";
+    }
+}
+
+void HybridPerfectVerify::save(std::ostream& out) const {
+    preprocessor.save(out);
+    io::write_pod<uint64_t>(out, num_keys);
+    table.save(out);
+    codes.save(out);
+}
+
+void HybridPerfectVerify::load(std::istream& in) {
+    preprocessor.load(in);
+    num_keys = io::read_pod<uint64_t>(in);
+    table.load(in);
+    codes.load(in);
+    if (codes.size() != num_keys || (num_keys > 0 && table.numBuckets() == 0)) {
+        throw std::runtime_error("Corrupt " + getName() + " index");
+    }
+    construction_stats = ConstructionStats();
+    construction_stats.success = true;
+}
+
+} // namespace hashing
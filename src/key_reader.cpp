@@ -0,0 +1,59 @@
+#include "key_reader.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+namespace hashing {
+
+KeyReader::KeyReader(std::istream& input, Format format) : in(input), fmt(format) {}
+
+bool KeyReader::next(std::string& key) {
+    if (fmt == Format::LINES) {
+        while (std::getline(in, key)) {
+            bytes_read += key.size() + 1;
+            if (!key.empty() && key.back() == '\r') {
+                key.pop_back();
+            }
+            if (key.empty()) continue;
+            keys_read++;
+            return true;
+        }
+        return false;
+    }
+
+    // Length-prefixed: 4-byte little-endian length, then payload
+    unsigned char len_bytes[4];
+    in.read(reinterpret_cast<char*>(len_bytes), 4);
+    if (in.gcount() == 0) return false;
+    if (in.gcount() != 4) {
+        throw std::runtime_error("Truncated length prefix after key " + std::to_string(keys_read));
+    }
+
+    uint32_t len = static_cast<uint32_t>(len_bytes[0]) |
+                   (static_cast<uint32_t>(len_bytes[1]) << 8) |
+                   (static_cast<uint32_t>(len_bytes[2]) << 16) |
+                   (static_cast<uint32_t>(len_bytes[3]) << 24);
+
+    key.resize(len);
+    if (len > 0) {
+        in.read(&key[0], len);
+        if (static_cast<uint32_t>(in.gcount()) != len) {
+            throw std::runtime_error("Truncated key payload after key " + std::to_string(keys_read));
+        }
+    }
+
+    bytes_read += 4 + len;
+    keys_read++;
+    return true;
+}
+
+std::vector<std::string> KeyReader::readAll() {
+    std::vector<std::string> keys;
+    std::string key;
+    while (next(key)) {
+        keys.push_back(std::move(key));
+    }
+    return keys;
+}
+
+} // namespace hashing
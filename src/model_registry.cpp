@@ -0,0 +1,100 @@
+#include "model_registry.hpp"
+#include "serialization.hpp"
+#include "bdz_pipeline_mphf.hpp"
+#include "cuckoo_perfect_hash.hpp"
+#include "ultimate_hybrid.hpp"
+#include "adaptive_security_hybrid.hpp"
+#include "parallel_verification_hybrid.hpp"
+#include "cache_partitioned_hybrid.hpp"
+#include "ultra_low_memory_hybrid.hpp"
+#include "two_path_hybrid.hpp"
+#include "hybrid_crypto_perfect.hpp"
+#include "hybrid_perfect_verify.hpp"
+#include "partitioned_mphf.hpp"
+#include "monotone_mphf.hpp"
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace hashing {
+
+namespace {
+
+const char INDEX_MAGIC[8] = {'H', 'A', 'S', 'H', 'I', 'D', 'X', '\0'};
+const uint32_t INDEX_FORMAT_VERSION = 11;
+
+using Factory = std::unique_ptr<HashModel> (*)();
+
+template <typename Model>
+std::unique_ptr<HashModel> make() {
+    return std::make_unique<Model>();
+}
+
+const std::vector<std::pair<std::string, Factory>>& registry() {
+    static const std::vector<std::pair<std::string, Factory>> models = {
+        {"bdz",               make<BDZPipelineMPHF>},
+        {"ultimate",          make<UltimateHybridHash>},
+        {"adaptive",          make<AdaptiveSecurityHybrid>},
+        {"parallel",          make<ParallelVerificationHybrid>},
+        {"cache-partitioned", make<CachePartitionedHybrid>},
+        {"ultra-low-memory",  make<UltraLowMemoryHybrid>},
+        {"two-path",          make<TwoPathHybrid>},
+        {"partitioned",       make<PartitionedMPHF>},
+        {"cuckoo",            make<CuckooPerfectHash>},
+        {"crypto-perfect",    make<HybridCryptoPerfect>},
+        {"perfect-verify",    make<HybridPerfectVerify>},
+        {"monotone",          make<MonotoneMPHF>},
+    };
+    return models;
+}
+
+} // namespace
+
+std::vector<std::string> availableModels() {
+    std::vector<std::string> ids;
+    for (const auto& entry : registry()) {
+        ids.push_back(entry.first);
+    }
+    return ids;
+}
+
+std::unique_ptr<HashModel> createModel(const std::string& id) {
+    for (const auto& entry : registry()) {
+        if (entry.first == id) {
+            return entry.second();
+        }
+    }
+    throw std::invalid_argument("Unknown model: " + id);
+}
+
+void saveIndex(const std::string& id, const HashModel& model, std::ostream& out) {
+    out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    io::write_pod(out, INDEX_FORMAT_VERSION);
+    io::write_string(out, id);
+    model.save(out);
+    out.flush();
+    if (!out) throw std::runtime_error("Failed to write index");
+}
+
+std::unique_ptr<HashModel> loadIndex(std::istream& in, std::string* id) {
+    char magic[sizeof(INDEX_MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a serialized hash index");
+    }
+
+    uint32_t version = io::read_pod<uint32_t>(in);
+    if (version != INDEX_FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported index format version " + std::to_string(version));
+    }
+
+    std::string model_id = io::read_string(in);
+    auto model = createModel(model_id);
+    model->load(in);
+
+    if (id) *id = model_id;
+    return model;
+}
+
+} // namespace hashing
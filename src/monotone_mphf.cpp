@@ -0,0 +1,296 @@
+#include "monotone_mphf.hpp"
+#include "duplicate_keys.hpp"
+#include "murmur_hash.hpp"
+#include "parallel.hpp"
+#include "serialization.hpp"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace hashing {
+
+namespace {
+
+// Bits of the prefix-free encoding: 9 per byte (marker + byte) plus the
+// terminating 0
+uint64_t encoded_bits(const std::string& key) { return 9 * static_cast<uint64_t>(key.size()) + 1; }
+
+// Common prefix of the encodings of a < b, in bits
+uint64_t encoded_lcp(const std::string& a, const std::string& b) {
+    size_t common = std::mismatch(a.begin(), a.end(), b.begin()).first - a.begin();
+    if (common == a.size()) {
+        return 9 * static_cast<uint64_t>(common);  // a's terminator (0) against b's marker (1)
+    }
+    uint8_t diff = static_cast<uint8_t>(a[common]) ^ static_cast<uint8_t>(b[common]);
+    uint64_t equal_bits = 0;
+    while ((diff & 0x80) == 0) {
+        diff <<= 1;
+        equal_bits++;
+    }
+    return 9 * static_cast<uint64_t>(common) + 1 + equal_bits;
+}
+
+unsigned bit_width(uint64_t x) {
+    unsigned bits = 0;
+    while (x) {
+        bits++;
+        x >>= 1;
+    }
+    return bits;
+}
+
+// 2^b keys per bucket, b = round(log2(ln 2 * log2 n)): minimizes the offset
+// bits (b) plus the bucket number bits (log2 n / 2^b) per key
+unsigned bucket_bits_for(size_t n) {
+    double target = std::log(2.0) * std::log2(static_cast<double>(std::max<size_t>(n, 4)));
+    long bits = std::lround(std::log2(target));
+    return static_cast<unsigned>(std::clamp(bits, 1L, 8L));
+}
+
+} // namespace
+
+uint64_t MonotoneMPHF::prefix_signature(const std::string& key, uint64_t lcp_bits) const {
+    size_t whole = static_cast<size_t>(lcp_bits / 9);
+    unsigned rest = static_cast<unsigned>(lcp_bits % 9);
+
+    // Leading bits of the next 9-bit symbol, behind a 1 that marks their count
+    uint64_t tail = 1;
+    if (rest > 0) {
+        uint64_t symbol = whole < key.size() ? (0x100 | static_cast<uint8_t>(key[whole])) : 0;
+        tail = (uint64_t(1) << rest) | (symbol >> (9 - rest));
+    }
+    uint64_t bytes = prefix_hasher(reinterpret_cast<const uint8_t*>(key.data()), whole);
+    return MurmurHash3::fmix64(bytes ^ (tail * 0x9e3779b97f4a7c15ULL));
+}
+
+bool MonotoneMPHF::build_index(BDZCore& index, const std::vector<uint64_t>& signatures, std::mt19937_64& gen) {
+    BDZCore::Layout layout = build_config.cache_local ? BDZCore::Layout::BLOCKED : BDZCore::Layout::UNIFORM;
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+        construction_stats.attempts++;
+        if (index.build(signatures.data(), signatures.size(), gen(), build_config.table_factor,
+                        BDZCore::GEncoding::TWO_BIT, layout, build_config.divert_core)) {
+            construction_stats.fallback_keys += index.fallbackKeys();
+            return true;
+        }
+    }
+    return false;
+}
+
+void MonotoneMPHF::build(const std::vector<std::string>& keys) {
+    std::mt19937_64 gen = build_rng();
+    construction_stats = ConstructionStats();
+    num_keys = keys.size();
+
+    // Sorted view of the keys; already sorted input keeps its order
+    std::vector<const std::string*> sorted(num_keys);
+    for (size_t i = 0; i < num_keys; i++) {
+        sorted[i] = &keys[i];
+    }
+    auto less = [](const std::string* a, const std::string* b) { return *a < *b; };
+    if (!std::is_sorted(sorted.begin(), sorted.end(), less)) {
+        std::sort(sorted.begin(), sorted.end(), less);
+    }
+
+    // Repeated keys have no rank of their own: report them, or keep one per
+    // run (the first in input order) when deduplicating
+    std::vector<size_t> repeats;
+    size_t distinct = 0;
+    for (size_t begin = 0, end; begin < num_keys; begin = end) {
+        const std::string* first = sorted[begin];
+        for (end = begin + 1; end < num_keys && *sorted[end] == *sorted[begin]; end++) {
+            first = std::min(first, sorted[end]);
+        }
+        for (size_t i = begin; i < end; i++) {
+            if (sorted[i] != first) repeats.push_back(static_cast<size_t>(sorted[i] - keys.data()));
+        }
+        sorted[distinct++] = first;
+    }
+    if (!repeats.empty()) {
+        std::sort(repeats.begin(), repeats.end());
+        reportDuplicates(construction_stats, repeats, getName(), build_config.deduplicate);
+        if (!build_config.deduplicate) {
+            num_keys = 0;
+            return;
+        }
+        sorted.resize(distinct);
+        num_keys = distinct;
+    }
+
+    bucket_bits = bucket_bits_for(num_keys);
+    size_t bucket_size = bucketSize();
+    size_t num_buckets = (num_keys + bucket_size - 1) / bucket_size;
+
+    // LCP of each bucket's first and last key; a single key is its own prefix
+    std::vector<uint64_t> lcps(num_buckets);
+    uint64_t max_lcp = 0;
+    for (size_t b = 0; b < num_buckets; b++) {
+        const std::string& first = *sorted[b * bucket_size];
+        const std::string& last = *sorted[std::min(num_keys, (b + 1) * bucket_size) - 1];
+        lcps[b] = (&first == &last) ? encoded_bits(first) : encoded_lcp(first, last);
+        max_lcp = std::max(max_lcp, lcps[b]);
+    }
+
+    key_hasher.reseed(gen, build_config.key_hash);
+    prefix_hasher.reseed(gen, build_config.key_hash);
+
+    std::vector<uint64_t> key_sigs(num_keys);
+    parallel_for(num_keys, build_config.num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            key_sigs[i] = key_hasher(*sorted[i]);
+        }
+    });
+    std::vector<uint64_t> prefix_sigs(num_buckets);
+    for (size_t b = 0; b < num_buckets; b++) {
+        prefix_sigs[b] = prefix_signature(*sorted[b * bucket_size], lcps[b]);
+    }
+
+    if (num_keys == 0) {
+        construction_stats.success = true;
+        return;
+    }
+    bool success = build_index(key_index, key_sigs, gen) && build_index(bucket_index, prefix_sigs, gen);
+    construction_stats.success = success;
+    if (!success) {
+        std::cerr << "Warning: " << getName() << " construction failed after "
+                  << construction_stats.attempts << " attempts\n";
+        return;
+    }
+
+    key_values.reset(num_keys, bit_width(max_lcp) + bucket_bits);
+    for (size_t i = 0; i < num_keys; i++) {
+        uint64_t offset = i & (bucket_size - 1);
+        key_values.set(key_index.lookup(key_sigs[i]), (lcps[i >> bucket_bits] << bucket_bits) | offset);
+    }
+    bucket_values.reset(num_buckets, std::max(1u, bit_width(num_buckets - 1)));
+    for (size_t b = 0; b < num_buckets; b++) {
+        bucket_values.set(bucket_index.lookup(prefix_sigs[b]), b);
+    }
+}
+
+uint64_t MonotoneMPHF::hash(const std::string& key) const {
+    if (num_keys == 0) return UINT64_MAX;
+
+    uint64_t slot = key_index.lookup(key_hasher(key));
+    if (slot == BDZCore::NOT_FOUND) {
+        return UINT64_MAX;
+    }
+    uint64_t value = key_values.get(slot);
+    uint64_t lcp = value >> bucket_bits;
+    if (lcp > encoded_bits(key)) {
+        return UINT64_MAX;  // Longer than the key: not in the set
+    }
+
+    uint64_t bucket_slot = bucket_index.lookup(prefix_signature(key, lcp));
+    if (bucket_slot == BDZCore::NOT_FOUND) {
+        return UINT64_MAX;
+    }
+    return rank(value, bucket_slot);
+}
+
+void MonotoneMPHF::hashBatch(const std::string* keys, size_t n, uint64_t* out) const {
+    if (num_keys == 0) {
+        std::fill(out, out + n, UINT64_MAX);
+        return;
+    }
+
+    uint64_t sigs[BATCH_SIZE];
+    uint64_t slots[BATCH_SIZE];
+    uint64_t values[BATCH_SIZE];
+    for (size_t begin = 0; begin < n; begin += BATCH_SIZE) {
+        size_t count = std::min(BATCH_SIZE, n - begin);
+        const std::string* group = keys + begin;
+
+        for (size_t i = 0; i < count; i++) {
+            sigs[i] = key_hasher(group[i]);
+            key_index.prefetch(sigs[i]);
+        }
+        key_index.lookupBatch(sigs, count, slots);
+        for (size_t i = 0; i < count; i++) {
+            if (slots[i] != BDZCore::NOT_FOUND) prefetch_read(key_values.locate(slots[i]));
+        }
+
+        // Bucket prefixes; keys already rejected keep a NOT_FOUND value
+        for (size_t i = 0; i < count; i++) {
+            values[i] = UINT64_MAX;
+            sigs[i] = 0;
+            if (slots[i] == BDZCore::NOT_FOUND) continue;
+            uint64_t lcp = key_values.get(slots[i]) >> bucket_bits;
+            if (lcp > encoded_bits(group[i])) continue;
+            values[i] = key_values.get(slots[i]);
+            sigs[i] = prefix_signature(group[i], lcp);
+            bucket_index.prefetch(sigs[i]);
+        }
+        bucket_index.lookupBatch(sigs, count, slots);
+        for (size_t i = 0; i < count; i++) {
+            if (slots[i] != BDZCore::NOT_FOUND) prefetch_read(bucket_values.locate(slots[i]));
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            bool found = values[i] != UINT64_MAX && slots[i] != BDZCore::NOT_FOUND;
+            out[begin + i] = found ? rank(values[i], slots[i]) : UINT64_MAX;
+        }
+    }
+}
+
+size_t MonotoneMPHF::getMemoryUsage() const {
+    return sizeof(*this) + key_index.sizeInBytes() + bucket_index.sizeInBytes() +
+           key_values.sizeInBytes() + bucket_values.sizeInBytes();
+}
+
+void MonotoneMPHF::save(std::ostream& out) const {
+    key_hasher.save(out);
+    prefix_hasher.save(out);
+    io::write_pod<uint32_t>(out, bucket_bits);
+    io::write_pod<uint64_t>(out, num_keys);
+    if (num_keys == 0) return;
+    key_index.save(out);
+    bucket_index.save(out);
+    key_values.save(out);
+    bucket_values.save(out);
+}
+
+void MonotoneMPHF::load(std::istream& in) {
+    key_hasher.load(in);
+    prefix_hasher.load(in);
+    bucket_bits = io::read_pod<uint32_t>(in);
+    num_keys = io::read_pod<uint64_t>(in);
+    if (bucket_bits == 0 || bucket_bits > 8) {
+        throw std::runtime_error("Corrupt monotone MPHF header");
+    }
+    if (num_keys > 0) {
+        key_index.load(in);
+        bucket_index.load(in);
+        key_values.load(in);
+        bucket_values.load(in);
+        if (key_index.numKeys() != num_keys || key_values.size() != num_keys ||
+            bucket_values.size() != bucket_index.numKeys()) {
+            throw std::runtime_error("Corrupt monotone MPHF tables");
+        }
+    }
+    construction_stats = ConstructionStats();
+    construction_stats.success = true;
+}
+
+void MonotoneMPHF::printStats() const {
+    double n = static_cast<double>(std::max<size_t>(num_keys, 1));
+    std::cout << "  Bucket size: " << bucketSize() << " keys ("
+              << bucket_index.numKeys() << " buckets)\n";
+    std::cout << std::fixed << std::setprecision(3)
+              << "  Key function: " << ((key_index.sizeInBytes() + key_values.sizeInBytes()) * 8.0 / n)
+              << " bits/key (" << key_values.width() << "-bit LCP length + offset)\n"
+              << "  Bucket function: " << ((bucket_index.sizeInBytes() + bucket_values.sizeInBytes()) * 8.0 / n)
+              << " bits/key\n"
+              << "  Memory: " << getMemoryUsage() << " bytes (" << (getMemoryUsage() * 8.0 / n)
+              << " bits/key)\n";
+    if (key_index.fallbackKeys() + bucket_index.fallbackKeys() > 0) {
+        std::cout << "  2-core fallback: " << key_index.fallbackKeys() << " keys, "
+                  << bucket_index.fallbackKeys() << " buckets\n";
+    }
+    if (construction_stats.success) {
+        std::cout << "  Construction attempts: " << construction_stats.attempts << "\n";
+    }
+}
+
+} // namespace hashing
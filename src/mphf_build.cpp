@@ -0,0 +1,408 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <cstdlib>
+#include <algorithm>
+#include <iterator>
+
+#include "adaptive_security_hybrid.hpp"
+#include "key_reader.hpp"
+#include "keyed_hash.hpp"
+#include "model_registry.hpp"
+#include "partitioned_mphf.hpp"
+#include "quality_analysis.hpp"
+#include "two_path_hybrid.hpp"
+
+using namespace hashing;
+
+// Offline index builder: reads keys from a file or stdin, builds the chosen
+// model and writes the serialized index for shipping to serving nodes.
+// With --external the partitioned model streams keys from the input and
+// spills signatures to disk, so key sets larger than RAM can be indexed.
+
+namespace {
+
+void print_usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options] -o <index-file>\n\n"
+              << "Options:\n"
+              << "  -i, --input <file>         Key file ('-' or omitted: stdin)\n"
+              << "  -f, --format <fmt>         lines | length-prefixed (default: lines)\n"
+              << "  -m, --model <id>           Model to build (default: bdz)\n"
+              << "      --fingerprint-bits <n> Verification fingerprint width, 1-64 (default: per model)\n"
+              << "      --load-factor <f>      Keys per MPHF vertex, 0 < f < 1 (default: 0.81)\n"
+              << "      --cache-local          BDZ layout with two of each key's three vertices in\n"
+              << "                             one cache line (two lines per lookup, not three)\n"
+              << "      --divert-core          BDZ: build in one peel, keys left in the 2-core go\n"
+              << "                             to a small secondary table instead of a reseed\n"
+              << "      --exact                Store the keys (front coded, by index) so lookups\n"
+              << "                             are exact; bdz, pipeline hybrids and two-path only\n"
+              << "      --adaptive-verification\n"
+              << "                             -m adaptive: verify 1/256 of lookups while checks\n"
+              << "                             pass, all of them while absent keys are probed\n"
+              << "      --lane-weights <file>  -m two-path: one line per input key, its access\n"
+              << "                             weight and optionally 's' (sensitive); the hottest\n"
+              << "                             non-sensitive keys take the fast lane\n"
+              << "      --fast-share <f>       Share of keys on the fast lane with --lane-weights,\n"
+              << "                             0-1 (default: 0.2)\n"
+              << "      --deduplicate          Drop repeated keys (first occurrence kept) instead\n"
+              << "                             of failing the build\n"
+              << "      --key-hash <hash>      Keyed preprocessing hash of the hybrids: siphash,\n"
+              << "                             siphash-1-2, aes, wide (default: per model)\n"
+              << "  -t, --threads <n>          Worker threads (default: 1)\n"
+              << "      --seed <n>             Build seed; same keys + seed give a byte-identical\n"
+              << "                             index for any thread count (default: random)\n"
+              << "      --quality-sample <n>   Report chi-square, max load and collisions over\n"
+              << "                             n sampled keys after the build (0: all keys)\n"
+              << "      --external             Out-of-core build (implies -m partitioned)\n"
+              << "      --tmp-dir <dir>        Spill directory for --external (default: system temp)\n"
+              << "      --partition-bits <n>   2^n partitions for --external, 0-24 (default: 8)\n"
+              << "  -o, --output <file>        Where to write the serialized index\n"
+              << "  -h, --help                 Show this message\n\n"
+              << "Models:";
+    for (const auto& id : availableModels()) {
+        std::cerr << " " << id;
+    }
+    std::cerr << "\n";
+}
+
+struct Options {
+    std::string input = "-";
+    std::string output;
+    std::string model = "bdz";
+    KeyReader::Format format = KeyReader::Format::LINES;
+    BuildConfig config;
+    bool analyze_quality = false;
+    QualityOptions quality;
+    bool external = false;
+    ExternalBuildOptions external_options;
+    bool adaptive_verification = false;
+    std::string lane_weights;  // Empty: no traffic-aware routing
+    double fast_share = 0.2;
+};
+
+template <typename T>
+T parse_number(const std::string& flag, const std::string& value) {
+    std::istringstream ss(value);
+    T result;
+    if (!(ss >> result) || !ss.eof()) {
+        throw std::invalid_argument("Invalid value for " + flag + ": " + value);
+    }
+    return result;
+}
+
+Options parse_args(int argc, char** argv) {
+    Options opts;
+    bool model_given = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+            return argv[++i];
+        };
+
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            std::exit(0);
+        } else if (arg == "-i" || arg == "--input") {
+            opts.input = value();
+        } else if (arg == "-o" || arg == "--output") {
+            opts.output = value();
+        } else if (arg == "-m" || arg == "--model") {
+            opts.model = value();
+            model_given = true;
+        } else if (arg == "-f" || arg == "--format") {
+            std::string fmt = value();
+            if (fmt == "lines") {
+                opts.format = KeyReader::Format::LINES;
+            } else if (fmt == "length-prefixed") {
+                opts.format = KeyReader::Format::LENGTH_PREFIXED;
+            } else {
+                throw std::invalid_argument("Unknown key format: " + fmt);
+            }
+        } else if (arg == "--fingerprint-bits") {
+            opts.config.fingerprint_bits = parse_number<unsigned>(arg, value());
+            if (opts.config.fingerprint_bits == 0 || opts.config.fingerprint_bits > 64) {
+                throw std::invalid_argument("--fingerprint-bits must be between 1 and 64");
+            }
+        } else if (arg == "--load-factor") {
+            double load = parse_number<double>(arg, value());
+            if (load <= 0.0 || load >= 1.0) {
+                throw std::invalid_argument("--load-factor must be in (0, 1)");
+            }
+            opts.config.table_factor = 1.0 / load;
+        } else if (arg == "--cache-local") {
+            opts.config.cache_local = true;
+        } else if (arg == "--divert-core") {
+            opts.config.divert_core = true;
+        } else if (arg == "--exact") {
+            opts.config.exact = true;
+        } else if (arg == "--adaptive-verification") {
+            opts.adaptive_verification = true;
+        } else if (arg == "--lane-weights") {
+            opts.lane_weights = value();
+        } else if (arg == "--fast-share") {
+            opts.fast_share = parse_number<double>(arg, value());
+            if (opts.fast_share < 0.0 || opts.fast_share > 1.0) {
+                throw std::invalid_argument("--fast-share must be in [0, 1]");
+            }
+        } else if (arg == "--deduplicate") {
+            opts.config.deduplicate = true;
+        } else if (arg == "--key-hash") {
+            std::string hash = value();
+            if (hash == "siphash") {
+                opts.config.key_hash = KeyHash::SIPHASH_2_4;
+            } else if (hash == "siphash-1-2") {
+                opts.config.key_hash = KeyHash::SIPHASH_1_2;
+            } else if (hash == "aes") {
+                if (!AES_HASH_AVAILABLE) {
+                    throw std::invalid_argument("--key-hash aes needs a build with AES-NI enabled");
+                }
+                opts.config.key_hash = KeyHash::AES;
+            } else if (hash == "wide") {
+                opts.config.key_hash = KeyHash::WIDE_MULTIPLY;
+            } else {
+                throw std::invalid_argument("Unknown key hash: " + hash);
+            }
+        } else if (arg == "-t" || arg == "--threads") {
+            opts.config.num_threads = parse_number<unsigned>(arg, value());
+            if (opts.config.num_threads == 0) {
+                throw std::invalid_argument("--threads must be at least 1");
+            }
+        } else if (arg == "--seed") {
+            opts.config.seeded = true;
+            opts.config.seed = parse_number<uint64_t>(arg, value());
+        } else if (arg == "--quality-sample") {
+            opts.analyze_quality = true;
+            opts.quality.sample_size = parse_number<size_t>(arg, value());
+        } else if (arg == "--external") {
+            opts.external = true;
+        } else if (arg == "--tmp-dir") {
+            opts.external_options.tmp_dir = value();
+        } else if (arg == "--partition-bits") {
+            opts.external_options.partition_bits = parse_number<unsigned>(arg, value());
+            if (opts.external_options.partition_bits > 24) {
+                throw std::invalid_argument("--partition-bits must be at most 24");
+            }
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+
+    if (opts.output.empty()) {
+        throw std::invalid_argument("No output file given (-o)");
+    }
+    if (opts.external) {
+        if (model_given && opts.model != "partitioned") {
+            throw std::invalid_argument("--external only supports -m partitioned");
+        }
+        opts.model = "partitioned";
+        if (opts.analyze_quality) {
+            throw std::invalid_argument("--quality-sample is not supported with --external");
+        }
+    }
+    if (opts.config.exact) {
+        static const char* const exact_models[] = {"bdz", "ultimate", "adaptive", "parallel", "cache-partitioned",
+                                                   "ultra-low-memory", "two-path", "crypto-perfect"};
+        if (std::find(std::begin(exact_models), std::end(exact_models), opts.model) == std::end(exact_models)) {
+            throw std::invalid_argument("--exact is not supported by -m " + opts.model);
+        }
+    }
+    if (opts.adaptive_verification && opts.model != "adaptive") {
+        throw std::invalid_argument("--adaptive-verification only applies to -m adaptive");
+    }
+    if (!opts.lane_weights.empty() && opts.model != "two-path") {
+        throw std::invalid_argument("--lane-weights only applies to -m two-path");
+    }
+    opts.quality.num_threads = opts.config.num_threads;
+    return opts;
+}
+
+// --lane-weights: "<weight>" or "<weight> s" per line, in key order
+void read_lane_weights(const std::string& path, size_t num_keys, std::vector<double>& weights,
+                       std::vector<uint8_t>& sensitive) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open lane weights file: " + path);
+    }
+    weights.reserve(num_keys);
+    sensitive.reserve(num_keys);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream ss(line);
+        double weight;
+        std::string flag;
+        if (!(ss >> weight) || ((ss >> flag) && flag != "s")) {
+            throw std::runtime_error("Bad lane weight on line " + std::to_string(weights.size() + 1) + " of " + path);
+        }
+        weights.push_back(weight);
+        sensitive.push_back(flag == "s" ? 1 : 0);
+    }
+    if (weights.size() != num_keys) {
+        throw std::runtime_error("Lane weights file has " + std::to_string(weights.size()) + " lines for " +
+                                 std::to_string(num_keys) + " keys");
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    try {
+        opts = parse_args(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n\n";
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        auto model = createModel(opts.model);
+        model->configure(opts.config);
+        if (opts.adaptive_verification) {
+            static_cast<AdaptiveSecurityHybrid&>(*model).setAdaptiveVerification();
+        }
+
+        std::ifstream file;
+        std::istream* in = &std::cin;
+        if (opts.input != "-") {
+            file.open(opts.input, std::ios::binary);
+            if (!file.is_open()) {
+                throw std::runtime_error("Could not open input file: " + opts.input);
+            }
+            in = &file;
+        }
+        KeyReader reader(*in, opts.format);
+
+        size_t num_keys = 0;
+        double build_ms = 0.0;
+        std::vector<std::string> quality_keys;  // Sample kept for --quality-sample
+
+        if (opts.external) {
+            // === STREAMING BUILD ===
+            auto& partitioned = static_cast<PartitionedMPHF&>(*model);
+            std::cerr << "Building " << model->getName() << " from stream ("
+                      << (size_t(1) << opts.external_options.partition_bits) << " partitions) ...\n";
+            auto build_start = std::chrono::high_resolution_clock::now();
+            partitioned.buildExternal(reader, opts.external_options);
+            auto build_end = std::chrono::high_resolution_clock::now();
+            build_ms = std::chrono::duration<double, std::milli>(build_end - build_start).count();
+
+            num_keys = reader.keysRead();
+            if (num_keys == 0) {
+                throw std::runtime_error("No keys read from " + opts.input);
+            }
+            std::cerr << "Streamed " << num_keys << " keys (" << reader.bytesRead() << " bytes)\n";
+        } else {
+            // === READ KEYS ===
+            auto read_start = std::chrono::high_resolution_clock::now();
+            std::vector<std::string> keys = reader.readAll();
+            auto read_end = std::chrono::high_resolution_clock::now();
+            double read_ms = std::chrono::duration<double, std::milli>(read_end - read_start).count();
+
+            if (keys.empty()) {
+                throw std::runtime_error("No keys read from " + opts.input);
+            }
+            num_keys = keys.size();
+
+            std::cerr << "Read " << keys.size() << " keys (" << reader.bytesRead() << " bytes) in "
+                      << std::fixed << std::setprecision(2) << read_ms << " ms\n";
+
+            if (opts.analyze_quality) {
+                quality_keys = sampleKeys(keys, opts.quality.sample_size, opts.quality.seed);
+            }
+
+            std::vector<double> weights;
+            std::vector<uint8_t> sensitive;
+            if (!opts.lane_weights.empty()) {
+                read_lane_weights(opts.lane_weights, keys.size(), weights, sensitive);
+            }
+
+            // === BUILD ===
+            std::cerr << "Building " << model->getName() << " ...\n";
+            auto build_start = std::chrono::high_resolution_clock::now();
+            if (opts.lane_weights.empty()) {
+                model->buildAndRelease(std::move(keys));
+            } else {
+                auto& two_path = static_cast<TwoPathHybrid&>(*model);
+                two_path.setFastLaneShare(opts.fast_share);
+                two_path.buildWeighted(keys, weights, sensitive);
+            }
+            auto build_end = std::chrono::high_resolution_clock::now();
+            build_ms = std::chrono::duration<double, std::milli>(build_end - build_start).count();
+        }
+
+        auto stats = model->getConstructionStats();
+        if (!stats.success) {
+            if (stats.duplicate_keys > 0) {
+                // The streaming build counts repeats up to the partition where it stopped
+                std::string found = stats.duplicate_positions.empty()
+                                        ? "repeated keys (" + std::to_string(stats.duplicate_keys) + " found)"
+                                        : std::to_string(stats.duplicate_keys) + " repeated key(s) (first is key #" +
+                                              std::to_string(stats.duplicate_positions.front()) + ")";
+                throw std::runtime_error("Input has " + found + "; index not written (--deduplicate drops them)");
+            }
+            throw std::runtime_error("Construction failed after " + std::to_string(stats.attempts) +
+                                     " attempts; index not written");
+        }
+        size_t duplicates_dropped = stats.duplicate_keys;
+        num_keys -= duplicates_dropped;
+
+        // === QUALITY (opt-in) ===
+        if (opts.analyze_quality) {
+            QualityOptions quality = opts.quality;
+            quality.sample_size = 0;  // Already sampled
+            quality.range = model->outputRange() ? model->outputRange() : num_keys;
+            stats = analyzeQuality(*model, quality_keys, quality);
+        }
+
+        // === WRITE ===
+        std::ofstream out(opts.output, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Could not open output file: " + opts.output);
+        }
+        saveIndex(opts.model, *model, out);
+        size_t file_bytes = static_cast<size_t>(out.tellp());
+        out.close();
+
+        double n = static_cast<double>(num_keys);
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "Model: " << opts.model << " (" << model->getName() << ")\n";
+        std::cout << "  Keys: " << num_keys << "\n";
+        if (duplicates_dropped > 0) {
+            std::cout << "  Duplicates dropped: " << duplicates_dropped << "\n";
+        }
+        std::cout << "  Threads: " << opts.config.num_threads << "\n";
+        if (opts.config.seeded) {
+            std::cout << "  Seed: " << opts.config.seed << "\n";
+        }
+        std::cout << "  Build time: " << build_ms << " ms ("
+                  << (n / (build_ms / 1000.0)) / 1e6 << " Mkeys/s)\n";
+        std::cout << "  Construction attempts: " << stats.attempts << "\n";
+        if (stats.fallback_keys > 0) {
+            std::cout << "  2-core fallback: " << stats.fallback_keys << " keys\n";
+        }
+        std::cout << std::setprecision(3);
+        std::cout << "  In-memory size: " << model->getMemoryUsage() << " bytes ("
+                  << model->getMemoryUsage() * 8.0 / n << " bits/key)\n";
+        std::cout << "  Index file: " << opts.output << ", " << file_bytes << " bytes ("
+                  << file_bytes * 8.0 / n << " bits/key)\n";
+        if (stats.quality_sample > 0) {
+            std::cout << std::setprecision(2);
+            std::cout << "  Quality (" << stats.quality_sample << " sampled keys): chi-square "
+                      << stats.chi_square << ", max load " << stats.max_load
+                      << ", collisions " << stats.collisions << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "numa_topology.hpp"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#ifdef __linux__
+    #include <sched.h>
+#endif
+
+namespace hashing {
+
+namespace {
+
+// "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}; malformed input gives {}
+std::vector<int> parse_list(const std::string& text) {
+    std::vector<int> values;
+    std::stringstream ranges(text);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        try {
+            size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int v = first; v <= last; v++) values.push_back(v);
+        } catch (const std::exception&) {
+            return {};
+        }
+    }
+    return values;
+}
+
+std::string read_line(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+NumaTopology read_system_topology() {
+#ifdef __linux__
+    std::vector<int> node_ids = parse_list(read_line("/sys/devices/system/node/online"));
+    std::vector<std::vector<int>> node_cpus;
+    for (int id : node_ids) {
+        std::vector<int> cpus =
+            parse_list(read_line("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist"));
+        if (!cpus.empty()) {
+            node_cpus.push_back(std::move(cpus));  // Memory-only nodes run no lookups
+        }
+    }
+    if (node_cpus.size() > 1) {
+        return NumaTopology(std::move(node_cpus));
+    }
+#endif
+    return NumaTopology();
+}
+
+} // namespace
+
+NumaTopology::NumaTopology(std::vector<std::vector<int>> cpus_per_node) : node_cpus(std::move(cpus_per_node)) {
+    for (size_t node = 0; node < node_cpus.size(); node++) {
+        for (int cpu : node_cpus[node]) {
+            if (cpu < 0) continue;
+            if (static_cast<size_t>(cpu) >= cpu_node.size()) {
+                cpu_node.resize(cpu + 1, 0);
+            }
+            cpu_node[cpu] = static_cast<uint16_t>(node);
+        }
+    }
+}
+
+const NumaTopology& NumaTopology::system() {
+    static const NumaTopology topology = read_system_topology();
+    return topology;
+}
+
+const std::vector<int>& NumaTopology::cpus(size_t node) const {
+    static const std::vector<int> none;
+    return node < node_cpus.size() ? node_cpus[node] : none;
+}
+
+size_t NumaTopology::currentNode() const {
+#ifdef __linux__
+    if (cpu_node.empty()) return 0;
+    int cpu = sched_getcpu();
+    if (cpu >= 0 && static_cast<size_t>(cpu) < cpu_node.size()) {
+        return cpu_node[cpu];
+    }
+#endif
+    return 0;
+}
+
+bool NumaTopology::bindThread(size_t node) const {
+#ifdef __linux__
+    const std::vector<int>& list = cpus(node);
+    if (list.empty()) return node_cpus.empty();
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : list) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)node;
+    return node_cpus.empty();
+#endif
+}
+
+} // namespace hashing
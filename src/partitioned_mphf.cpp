@@ -0,0 +1,340 @@
+#include "partitioned_mphf.hpp"
+#include "duplicate_keys.hpp"
+#include "murmur_hash.hpp"
+#include "parallel.hpp"
+#include "serialization.hpp"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <stdexcept>
+#include <algorithm>
+#include <random>
+
+namespace hashing {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Temporary spill directory, removed with everything in it on scope exit.
+// The name is drawn from std::random_device, not the build RNG, so seeded
+// builds stay reproducible and concurrent builds never share a directory.
+class SpillDirectory {
+public:
+    explicit SpillDirectory(const std::string& base) {
+        fs::path root = base.empty() ? fs::temp_directory_path() : fs::path(base);
+        std::random_device rd;
+        std::ostringstream name;
+        name << "mphf_spill_" << std::hex << rd() << rd();
+        path = root / name.str();
+        fs::create_directories(path);
+    }
+
+    ~SpillDirectory() {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+
+    fs::path file(size_t partition) const {
+        return path / ("part_" + std::to_string(partition) + ".sig");
+    }
+
+private:
+    fs::path path;
+};
+
+} // namespace
+
+PartitionedMPHF::Signature PartitionedMPHF::signature(const std::string& key) const {
+    return Signature{MurmurHash3::hash64(key, sig_seed0), MurmurHash3::hash64(key, sig_seed1)};
+}
+
+size_t PartitionedMPHF::partition_of(const Signature& sig) const {
+    return partition_bits == 0 ? 0 : static_cast<size_t>(sig.hi >> (64 - partition_bits));
+}
+
+void PartitionedMPHF::init_seeds(std::mt19937_64& gen) {
+    sig_seed0 = gen();
+    sig_seed1 = gen();
+    if (sig_seed1 == sig_seed0) sig_seed1 = ~sig_seed0;
+    construction_stats = ConstructionStats();
+}
+
+bool PartitionedMPHF::build_partition(size_t p, uint64_t* lo, uint64_t* hi, size_t& n, std::mt19937_64& gen) {
+    BDZCore::Layout layout = build_config.cache_local ? BDZCore::Layout::BLOCKED : BDZCore::Layout::UNIFORM;
+    for (int attempt = 0; attempt < 100; attempt++) {
+        construction_stats.attempts++;
+        if (partitions[p].build(lo, n, gen(), build_config.table_factor,
+                                BDZCore::GEncoding::TWO_BIT, layout, build_config.divert_core)) {
+            construction_stats.fallback_keys += partitions[p].fallbackKeys();
+            return true;
+        }
+        if (partitions[p].equalSignatures()) {
+            // No seed separates equal lo values. Repeated keys match in hi
+            // too: drop them or stop here. Distinct keys that share lo
+            // would alias each other's index, so they stop the build.
+            std::vector<std::pair<uint64_t, uint64_t>> sigs(n);
+            for (size_t i = 0; i < n; i++) {
+                sigs[i] = {lo[i], hi[i]};
+            }
+            std::sort(sigs.begin(), sigs.end());
+            size_t distinct = 0;
+            for (size_t i = 0; i < n; i++) {
+                if (distinct > 0 && sigs[i].first == lo[distinct - 1]) {
+                    if (sigs[i].second != hi[distinct - 1]) {
+                        std::cerr << "Warning: " << getName() << ": distinct keys share a partition signature "
+                                  << "in partition " << p << "; rebuild with another seed\n";
+                        return false;
+                    }
+                    continue;
+                }
+                lo[distinct] = sigs[i].first;
+                hi[distinct] = sigs[i].second;
+                distinct++;
+            }
+            construction_stats.duplicate_keys += n - distinct;
+            if (!build_config.deduplicate) return false;
+            n = distinct;
+        }
+    }
+    std::cerr << "Warning: partition " << p << " (" << n << " keys) failed after 100 attempts\n";
+    return false;
+}
+
+void PartitionedMPHF::build(const std::vector<std::string>& keys) {
+    std::mt19937_64 gen = build_rng();
+    init_seeds(gen);
+
+    num_keys = keys.size();
+    partition_bits = 0;
+    while (partition_bits < 24 && (num_keys >> partition_bits) > TARGET_PARTITION_KEYS) {
+        partition_bits++;
+    }
+    size_t num_partitions = size_t(1) << partition_bits;
+
+    // Hash every key once
+    std::vector<Signature> sigs(num_keys);
+    parallel_for(num_keys, build_config.num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            sigs[i] = signature(keys[i]);
+        }
+    });
+
+    // Counting sort of the in-partition signatures by partition
+    std::vector<uint64_t> counts(num_partitions + 1, 0);
+    for (const auto& sig : sigs) {
+        counts[partition_of(sig) + 1]++;
+    }
+    for (size_t p = 0; p < num_partitions; p++) {
+        counts[p + 1] += counts[p];
+    }
+
+    std::vector<uint64_t> grouped(num_keys), grouped_hi(num_keys);
+    std::vector<uint64_t> cursor(counts.begin(), counts.end() - 1);
+    for (const auto& sig : sigs) {
+        size_t slot = cursor[partition_of(sig)]++;
+        grouped[slot] = sig.lo;
+        grouped_hi[slot] = sig.hi;
+    }
+    std::vector<Signature>().swap(sigs);
+
+    partitions.assign(num_partitions, BDZCore());
+    offsets.assign(counts.begin(), counts.end() - 1);
+
+    bool success = true;
+    uint64_t offset = 0;
+    for (size_t p = 0; p < num_partitions && success; p++) {
+        size_t n = counts[p + 1] - counts[p];
+        success = build_partition(p, grouped.data() + counts[p], grouped_hi.data() + counts[p], n, gen);
+        offsets[p] = offset;
+        offset += n;
+    }
+    construction_stats.success = success;
+    if (construction_stats.duplicate_keys == 0) return;
+
+    // Input positions of the repeats, from the full 128-bit signatures
+    std::vector<uint64_t> hi(keys.size()), lo(keys.size());
+    parallel_for(keys.size(), build_config.num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            Signature sig = signature(keys[i]);
+            hi[i] = sig.hi;
+            lo[i] = sig.lo;
+        }
+    });
+    std::vector<size_t> repeats = findDuplicateSignatures(hi.data(), lo.data(), keys.size(),
+                                                          build_config.num_threads);
+    if (repeats.empty()) {
+        std::cerr << "Warning: " << getName() << ": distinct keys share a signature; "
+                  << "rebuild with another seed\n";
+        return;
+    }
+    reportDuplicates(construction_stats, repeats, getName(), build_config.deduplicate);
+    if (success) num_keys = offset;
+}
+
+void PartitionedMPHF::buildExternal(KeyReader& reader, const ExternalBuildOptions& options) {
+    if (options.partition_bits > 24) {
+        throw std::invalid_argument("partition_bits must be at most 24");
+    }
+
+    std::mt19937_64 gen = build_rng();
+    init_seeds(gen);
+
+    partition_bits = options.partition_bits;
+    size_t num_partitions = size_t(1) << partition_bits;
+    size_t buffer_keys = std::max<size_t>(1, options.spill_buffer_keys);
+
+    SpillDirectory spill(options.tmp_dir);
+
+    // Pass 1: stream keys, spill signatures by partition with appends
+    std::vector<std::vector<Signature>> buffers(num_partitions);
+    std::vector<uint64_t> counts(num_partitions, 0);
+
+    auto flush = [&](size_t p) {
+        if (buffers[p].empty()) return;
+        std::ofstream out(spill.file(p), std::ios::binary | std::ios::app);
+        out.write(reinterpret_cast<const char*>(buffers[p].data()),
+                  buffers[p].size() * sizeof(Signature));
+        if (!out) {
+            throw std::runtime_error("Failed to write spill file " + spill.file(p).string());
+        }
+        buffers[p].clear();
+    };
+
+    std::string key;
+    num_keys = 0;
+    while (reader.next(key)) {
+        Signature sig = signature(key);
+        size_t p = partition_of(sig);
+        if (buffers[p].empty()) buffers[p].reserve(buffer_keys);
+        buffers[p].push_back(sig);
+        counts[p]++;
+        num_keys++;
+        if (buffers[p].size() >= buffer_keys) flush(p);
+    }
+    for (size_t p = 0; p < num_partitions; p++) {
+        flush(p);
+        std::vector<Signature>().swap(buffers[p]);
+    }
+
+    // Pass 2: one partition in memory at a time
+    partitions.assign(num_partitions, BDZCore());
+    offsets.assign(num_partitions, 0);
+
+    bool success = true;
+    uint64_t offset = 0;
+    std::vector<uint64_t> part, part_hi;
+    std::vector<Signature> chunk(buffer_keys);
+
+    for (size_t p = 0; p < num_partitions && success; p++) {
+        part.clear();
+        part_hi.clear();
+        part.reserve(counts[p]);
+        part_hi.reserve(counts[p]);
+        if (counts[p] > 0) {
+            std::ifstream in(spill.file(p), std::ios::binary);
+            uint64_t remaining = counts[p];
+            while (remaining > 0) {
+                size_t batch = static_cast<size_t>(std::min<uint64_t>(remaining, chunk.size()));
+                in.read(reinterpret_cast<char*>(chunk.data()), batch * sizeof(Signature));
+                if (!in) {
+                    throw std::runtime_error("Truncated spill file " + spill.file(p).string());
+                }
+                for (size_t i = 0; i < batch; i++) {
+                    part.push_back(chunk[i].lo);
+                    part_hi.push_back(chunk[i].hi);
+                }
+                remaining -= batch;
+            }
+            in.close();
+            fs::remove(spill.file(p));
+        }
+
+        size_t n = part.size();
+        success = build_partition(p, part.data(), part_hi.data(), n, gen);
+        offsets[p] = offset;
+        offset += n;
+        std::vector<uint64_t>().swap(part);
+        std::vector<uint64_t>().swap(part_hi);
+    }
+
+    construction_stats.success = success;
+    if (construction_stats.duplicate_keys > 0) {
+        // Input positions are not kept by the streaming build: count only
+        std::cerr << "Warning: " << getName() << ": " << construction_stats.duplicate_keys
+                  << " repeated key(s)"
+                  << (build_config.deduplicate ? "; dropped\n" : "; construction stopped at the first partition with repeats\n");
+        if (success) num_keys = offset;
+    }
+}
+
+uint64_t PartitionedMPHF::hash(const std::string& key) const {
+    if (partitions.empty()) return UINT64_MAX;
+
+    Signature sig = signature(key);
+    size_t p = partition_of(sig);
+    uint64_t local = partitions[p].lookup(sig.lo);
+    if (local == BDZCore::NOT_FOUND) {
+        return UINT64_MAX;
+    }
+    return offsets[p] + local;
+}
+
+size_t PartitionedMPHF::getMemoryUsage() const {
+    size_t total = sizeof(*this) + offsets.size() * sizeof(uint64_t);
+    for (const auto& part : partitions) {
+        total += part.sizeInBytes();
+    }
+    return total;
+}
+
+void PartitionedMPHF::save(std::ostream& out) const {
+    io::write_pod(out, sig_seed0);
+    io::write_pod(out, sig_seed1);
+    io::write_pod<uint32_t>(out, partition_bits);
+    io::write_pod<uint64_t>(out, num_keys);
+    io::write_vector(out, offsets);
+    for (const auto& part : partitions) {
+        part.save(out);
+    }
+}
+
+void PartitionedMPHF::load(std::istream& in) {
+    sig_seed0 = io::read_pod<uint64_t>(in);
+    sig_seed1 = io::read_pod<uint64_t>(in);
+    partition_bits = io::read_pod<uint32_t>(in);
+    num_keys = io::read_pod<uint64_t>(in);
+    io::read_vector(in, offsets);
+    if (partition_bits > 24 || offsets.size() != (size_t(1) << partition_bits)) {
+        throw std::runtime_error("Corrupt partitioned MPHF header");
+    }
+    partitions.assign(offsets.size(), BDZCore());
+    for (auto& part : partitions) {
+        part.load(in);
+    }
+    construction_stats = ConstructionStats();
+    construction_stats.success = true;
+}
+
+void PartitionedMPHF::printStats() const {
+    size_t largest = 0;
+    size_t fallback_keys = 0;
+    for (const auto& part : partitions) {
+        largest = std::max(largest, part.numKeys());
+        fallback_keys += part.fallbackKeys();
+    }
+
+    std::cout << "  Partitions: " << partitions.size() << " (2^" << partition_bits << ")\n";
+    std::cout << "  Keys/partition: avg " << (partitions.empty() ? 0 : num_keys / partitions.size())
+              << ", max " << largest << "\n";
+    std::cout << "  Memory: " << getMemoryUsage() << " bytes ("
+              << std::fixed << std::setprecision(3) << (getMemoryUsage() * 8.0 / num_keys) << " bits/key)\n";
+    if (fallback_keys > 0) {
+        std::cout << "  2-core fallback: " << fallback_keys << " keys\n";
+    }
+    std::cout << "  Construction attempts (all partitions): " << construction_stats.attempts << "\n";
+}
+
+} // namespace hashing
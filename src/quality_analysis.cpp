@@ -0,0 +1,95 @@
+#include "quality_analysis.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <random>
+
+namespace hashing {
+
+std::vector<std::string> sampleKeys(const std::vector<std::string>& keys, size_t n, uint64_t seed) {
+    if (n == 0 || n >= keys.size()) {
+        return keys;
+    }
+
+    // Selection sampling (Knuth, Algorithm S): one pass, no index buffer
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    std::vector<std::string> sample;
+    sample.reserve(n);
+    size_t remaining = keys.size();
+    for (size_t i = 0; i < keys.size() && sample.size() < n; i++, remaining--) {
+        if (uniform(gen) * remaining < n - sample.size()) {
+            sample.push_back(keys[i]);
+        }
+    }
+    return sample;
+}
+
+ConstructionStats analyzeQuality(const HashModel& model, const std::vector<std::string>& keys,
+                                 const QualityOptions& options) {
+    ConstructionStats stats = model.getConstructionStats();
+
+    std::vector<std::string> sampled;
+    const std::vector<std::string>* sample = &keys;
+    if (options.sample_size != 0 && options.sample_size < keys.size()) {
+        sampled = sampleKeys(keys, options.sample_size, options.seed);
+        sample = &sampled;
+    }
+
+    size_t range = options.range;
+    if (range == 0) {
+        range = model.outputRange() != 0 ? model.outputRange() : keys.size();
+    }
+    if (sample->empty() || range == 0) {
+        return stats;
+    }
+
+    // Lookups dominate the cost, run them in parallel
+    std::vector<uint64_t> values(sample->size());
+    parallel_for(sample->size(), options.num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            values[i] = model.hash((*sample)[i]);
+        }
+    });
+
+    values.erase(std::remove_if(values.begin(), values.end(),
+                                [range](uint64_t v) { return v >= range; }),
+                 values.end());
+    std::sort(values.begin(), values.end());
+
+    // Max load and collisions over exact output values
+    size_t max_load = 0;
+    size_t collisions = 0;
+    for (size_t i = 0; i < values.size();) {
+        size_t j = i + 1;
+        while (j < values.size() && values[j] == values[i]) j++;
+        max_load = std::max(max_load, j - i);
+        collisions += j - i - 1;
+        i = j;
+    }
+
+    // Chi-square over equal-width buckets of the output range
+    size_t num_buckets = std::max<size_t>(1, std::min(range, values.size()));
+    std::vector<size_t> bucket_counts(num_buckets, 0);
+    for (uint64_t v : values) {
+        size_t bucket = static_cast<size_t>((static_cast<double>(v) / range) * num_buckets);
+        bucket_counts[std::min(bucket, num_buckets - 1)]++;
+    }
+
+    double expected = static_cast<double>(values.size()) / num_buckets;
+    double chi_square = 0.0;
+    if (expected > 0.0) {
+        for (size_t count : bucket_counts) {
+            double diff = count - expected;
+            chi_square += (diff * diff) / expected;
+        }
+    }
+
+    stats.chi_square = chi_square;
+    stats.max_load = max_load;
+    stats.collisions = collisions;
+    stats.quality_sample = sample->size();
+    return stats;
+}
+
+} // namespace hashing
@@ -6,20 +6,49 @@
 #include <memory>
 #include <random>
 #include <iomanip>
+#include <stdexcept>
+#include <thread>
+#include <sstream>
+#include <algorithm>
+#include <type_traits>
 
-// Include svih 9 algoritama
+// Include svih 12 algoritama
 #include "basic_perfect_hash.hpp"
 #include "basic_crypto_hash.hpp"
 #include "bdz_mphf.hpp"
+#include "cuckoo_perfect_hash.hpp"
 #include "ultimate_hybrid.hpp"
 #include "adaptive_security_hybrid.hpp"
 #include "parallel_verification_hybrid.hpp"
 #include "cache_partitioned_hybrid.hpp"
 #include "ultra_low_memory_hybrid.hpp"
 #include "two_path_hybrid.hpp"
+#include "hybrid_crypto_perfect.hpp"
+#include "hybrid_perfect_verify.hpp"
+#include "lookup.hpp"
+#include "coroutine_lookup.hpp"
+#include "huge_page_allocator.hpp"
+#include "numa_replicated.hpp"
+#include "fixed_key_models.hpp"
+#include "monotone_mphf.hpp"
 
 using namespace hashing;
 
+// Lookup checksums land here so the timed loops cannot be optimized away
+volatile uint64_t benchmark_sink = 0;
+
+// --numa: posle obicnog merenja, jedna kopija naspram replike po cvoru
+bool numa_compare = false;
+
+// --preprocessors: samo merenje kljucnih hesheva po duzini kljuca
+bool preprocessor_sweep = false;
+
+// --fixed-keys: samo celobrojni i UUID kljucevi, kao stringovi naspram tipiziranih
+bool fixed_key_sweep = false;
+
+// --monotone: samo monotoni MPHF naspram MPHF-a sa nizom rangova
+bool monotone_sweep = false;
+
 // Generisanje uniformnih ključeva
 std::vector<std::string> generateKeys(size_t n) {
     std::vector<std::string> keys;
@@ -32,7 +61,481 @@ std::vector<std::string> generateKeys(size_t n) {
     return keys;
 }
 
-int main() {
+// Lookup na svim CPU-ovima odjednom, svaka nit vezana za svoj NUMA cvor i
+// sa svojim delom kljuceva. `pick(node)` bira kopiju indeksa za cvor.
+// Vraca ukupni protok u Mops/s.
+template <typename Model, typename Pick>
+double parallelLookupMops(const NumaTopology& topo, const std::vector<std::string>& keys, Pick pick) {
+    std::vector<size_t> thread_nodes;
+    for (size_t node = 0; node < topo.numNodes(); node++) {
+        for (size_t c = 0; c < topo.cpus(node).size(); c++) {
+            thread_nodes.push_back(node);
+        }
+    }
+
+    size_t per_thread = (keys.size() + thread_nodes.size() - 1) / thread_nodes.size();
+    std::vector<uint64_t> checksums(thread_nodes.size(), 0);
+    std::vector<std::thread> workers;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t t = 0; t < thread_nodes.size(); t++) {
+        workers.emplace_back([&, t] {
+            size_t node = thread_nodes[t];
+            topo.bindThread(node);
+            size_t begin = std::min(keys.size(), t * per_thread);
+            size_t end = std::min(keys.size(), begin + per_thread);
+            const Model& model = pick(node);
+            checksums[t] = lookupChecksum(model, keys.data() + begin, end - begin);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    for (uint64_t checksum : checksums) {
+        benchmark_sink = benchmark_sink ^ checksum;
+    }
+    double sec = std::chrono::duration<double>(end - start).count();
+    return (keys.size() / sec) / 1e6;
+}
+
+// Jedna kopija (na cvoru gde je izgradjena) naspram replike po cvoru
+template <typename Model>
+void benchmarkNuma(const Model& model, const std::vector<std::string>& keys, const std::string& name,
+                   std::ofstream& csv) {
+    const NumaTopology& topo = NumaTopology::system();
+    NumaReplicated<Model> replicated(model, topo);
+
+    double single_mops = parallelLookupMops<Model>(topo, keys, [&](size_t) -> const Model& {
+        return model;
+    });
+    double replicated_mops = parallelLookupMops<Model>(topo, keys, [&](size_t node) -> const Model& {
+        return replicated.replica(node);
+    });
+
+    std::cout << "    NUMA (" << topo.numNodes() << " nodes): single copy " << single_mops
+              << " Mops/s, replicated " << replicated_mops << " Mops/s\n";
+
+    double memory_mb = model.getMemoryUsage() / (1024.0 * 1024.0);
+    csv << std::fixed << std::setprecision(6)
+        << name << " [NUMA single]," << keys.size() << ",0.0," << single_mops << ","
+        << std::setprecision(3) << memory_mb << ",0.0\n";
+    csv << std::fixed << std::setprecision(6)
+        << name << " [NUMA replicated]," << keys.size() << ",0.0," << replicated_mops << ","
+        << std::setprecision(3) << memory_mb * replicated.numReplicas() << ",0.0\n";
+    csv.flush();
+}
+
+// Jedan templejtovani drajver po konkretnom modelu: lookup petlja se
+// instancira za tip modela, bez virtuelnog poziva po kljucu
+//
+// `variant` (npr. " [4K pages]") se dodaje imenu u ispisu i u CSV-u
+template <typename Model>
+void benchmarkModel(const std::vector<std::string>& keys, int index, int total, std::ofstream& csv,
+                    const std::string& variant) {
+    Model model;
+    size_t size = keys.size();
+    std::string name = model.getName() + variant;
+
+    std::cout << "[" << index << "/" << total << "] " << std::setw(40) << std::left 
+              << name << " ... ";
+    std::cout.flush();
+    
+    try {
+        // Fixed build seed: runs differ only in code, not in seed luck
+        BuildConfig config;
+        config.seeded = true;
+        config.seed = 42;
+        model.configure(config);
+
+        // === BULK INSERT ===
+        auto insert_start = std::chrono::high_resolution_clock::now();
+        model.build(keys);
+        auto insert_end = std::chrono::high_resolution_clock::now();
+        
+        double insert_sec = std::chrono::duration<double>(insert_end - insert_start).count();
+        double insert_mops = (size / insert_sec) / 1e6;
+        
+        // === BULK LOOKUP ===
+        auto lookup_start = std::chrono::high_resolution_clock::now();
+        uint64_t checksum = lookupChecksum(model, keys);
+        auto lookup_end = std::chrono::high_resolution_clock::now();
+        benchmark_sink = benchmark_sink ^ checksum;
+        
+        double lookup_sec = std::chrono::duration<double>(lookup_end - lookup_start).count();
+        double lookup_mops = (size / lookup_sec) / 1e6;
+        
+        // === MEMORY ===
+        double memory_mb = model.getMemoryUsage() / (1024.0 * 1024.0);
+        
+        // === EFFICIENCY: Lookup throughput per MB ===
+        double efficiency = (memory_mb > 0.0) ? (lookup_mops / memory_mb) : 0.0;
+        
+        // Ispis
+        std::cout << "Insert: " << std::fixed << std::setprecision(2) 
+                  << insert_mops << " Mops/s, "
+                  << "Lookup: " << lookup_mops << " Mops/s, "
+                  << "Mem: " << memory_mb << " MB, "
+                  << "Eff: " << efficiency << " Ops/MB\n";
+        
+        // Upis u CSV
+        csv << std::fixed << std::setprecision(6)
+            << name << ","
+            << size << ","
+            << insert_mops << ","
+            << lookup_mops << ","
+            << std::setprecision(3) << memory_mb << ","
+            << std::setprecision(6) << efficiency << "\n";
+        csv.flush(); // Flush nakon svakog testa
+
+#ifdef HASHING_COROUTINES
+        // Isti kljucevi kroz coroutine lookup engine (grupa od 16 u letu)
+        if constexpr (detail::has_hash_coroutine<Model>::value) {
+            auto coro_start = std::chrono::high_resolution_clock::now();
+            uint64_t coro_checksum = interleavedChecksum(model, keys);
+            auto coro_end = std::chrono::high_resolution_clock::now();
+            benchmark_sink = benchmark_sink ^ coro_checksum;
+
+            double coro_mops = (size / std::chrono::duration<double>(coro_end - coro_start).count()) / 1e6;
+            std::cout << "    Interleaved (coroutines): " << coro_mops << " Mops/s"
+                      << (coro_checksum == checksum ? "" : " [CHECKSUM MISMATCH]") << "\n";
+            csv << std::fixed << std::setprecision(6)
+                << name << " [coroutines]," << size << "," << insert_mops << "," << coro_mops << ","
+                << std::setprecision(3) << memory_mb << ","
+                << std::setprecision(6) << (memory_mb > 0.0 ? coro_mops / memory_mb : 0.0) << "\n";
+            csv.flush();
+        }
+#endif
+
+        if (numa_compare) {
+            benchmarkNuma(model, keys, name, csv);
+        }
+        
+    } catch (const std::exception& e) {
+        std::cout << "FAILED: " << e.what() << "\n";
+        
+        // Upisivanje neuspelog testa
+        csv << name << ","
+            << size << ","
+            << "0.0,0.0,0.0,0.0\n";
+        csv.flush();
+    }
+}
+
+using ModelBenchmark = void (*)(const std::vector<std::string>&, int, int, std::ofstream&,
+                                const std::string&);
+
+// Protok svakog hesha za predobradu (KeyHash) po duzini kljuca: ns po
+// kljucu i GB/s, da se za svaku primenu izabere odnos otpornosti na DoS i
+// brzine
+void benchmarkPreprocessors() {
+    struct Candidate {
+        KeyHash hash;
+        const char* name;
+    };
+    std::vector<Candidate> candidates = {
+        {KeyHash::SIPHASH_2_4, "SipHash-2-4"},
+        {KeyHash::SIPHASH_1_2, "SipHash-1-2"},
+        {KeyHash::WIDE_MULTIPLY, "Wide-multiply"},
+    };
+    if (AES_HASH_AVAILABLE) {
+        candidates.push_back({KeyHash::AES, "AES"});
+    }
+
+    const size_t num_keys = 1 << 12;  // Kljucevi ostaju u kesu: meri se hesh, ne memorija
+    const size_t total_bytes = size_t(64) << 20;  // Isti obim podataka za svaku duzinu
+    std::ofstream csv("preprocessor_results.csv");
+    csv << "Hash,Key_Bytes,Ns_Per_Key,GB_Per_Sec\n";
+
+    std::cout << "=== Keyed preprocessing hashes ===\n";
+    std::cout << std::left << std::setw(16) << "Key bytes";
+    for (const Candidate& c : candidates) {
+        std::cout << std::setw(24) << c.name;
+    }
+    std::cout << "\n";
+
+    std::mt19937_64 rng(42);
+    for (size_t length : {8, 16, 32, 64, 128, 256}) {
+        std::vector<std::string> keys(num_keys, std::string(length, '\0'));
+        for (std::string& key : keys) {
+            for (char& c : key) c = static_cast<char>(rng());
+        }
+        size_t rounds = std::max<size_t>(1, total_bytes / (num_keys * length));
+
+        std::cout << std::setw(16) << length;
+        for (const Candidate& c : candidates) {
+            KeyedPreprocessor<KeyHash::SIPHASH_2_4> preprocessor;
+            std::mt19937_64 gen(7);
+            preprocessor.reseed(gen, c.hash);
+
+            uint64_t checksum = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t r = 0; r < rounds; r++) {
+                for (const std::string& key : keys) {
+                    checksum ^= preprocessor(key);
+                }
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            benchmark_sink = benchmark_sink ^ checksum;
+
+            double ns = std::chrono::duration<double, std::nano>(end - start).count() / (rounds * num_keys);
+            double gbps = length / ns;
+            std::ostringstream cell;
+            cell << std::fixed << std::setprecision(2) << ns << " ns  " << gbps << " GB/s";
+            std::cout << std::setw(24) << cell.str();
+            csv << c.name << "," << length << "," << ns << "," << gbps << "\n";
+        }
+        std::cout << "\n";
+    }
+    std::cout << "\nRezultati sacuvani u: preprocessor_results.csv\n";
+}
+
+// UUID u kanonskom tekstualnom obliku (36 znakova), kao u main.cpp
+std::string formatUuid(const Uuid& uuid) {
+    static const char hex[] = "0123456789abcdef";
+    std::string text;
+    text.reserve(36);
+    for (size_t i = 0; i < uuid.size(); i++) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) text.push_back('-');
+        text.push_back(hex[uuid[i] >> 4]);
+        text.push_back(hex[uuid[i] & 0x0F]);
+    }
+    return text;
+}
+
+// Lookup preko hashBatch u grupama od 64; `convert` pretvara kljuc u tip
+// modela (za string modele: formatiranje pri svakom lookup-u). Mops/s.
+template <typename Model, typename Key, typename Convert>
+double fixedKeyLookupMops(const Model& model, const std::vector<Key>& keys, Convert convert) {
+    using ModelKey = std::decay_t<decltype(convert(keys[0]))>;
+    const size_t group = 64;
+    ModelKey converted[group];
+    uint64_t out[group];
+    uint64_t checksum = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t begin = 0; begin < keys.size(); begin += group) {
+        size_t count = std::min(group, keys.size() - begin);
+        for (size_t i = 0; i < count; i++) {
+            converted[i] = convert(keys[begin + i]);
+        }
+        model.hashBatch(converted, count, out);
+        for (size_t i = 0; i < count; i++) {
+            checksum ^= out[i];
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    benchmark_sink = benchmark_sink ^ checksum;
+    return (keys.size() / std::chrono::duration<double>(end - start).count()) / 1e6;
+}
+
+// Isti model nad kljucevima formatiranim u stringove i nad tipiziranim
+// kljucevima: vreme izgradnje i lookup protok
+template <typename StringModel, typename FixedModel, typename Key, typename Format>
+void compareFixedKeys(const std::string& name, const std::vector<Key>& keys, Format format,
+                      std::ofstream& csv) {
+    auto timed_build = [](auto& model, const auto& build_keys) {
+        auto start = std::chrono::high_resolution_clock::now();
+        model.build(build_keys);
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    // String model: formatiranje je deo izgradnje
+    StringModel string_model;
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::string> formatted;
+    formatted.reserve(keys.size());
+    for (const Key& key : keys) {
+        formatted.push_back(format(key));
+    }
+    double format_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    double string_build_ms = format_ms + timed_build(string_model, formatted);
+
+    FixedModel fixed_model;
+    double fixed_build_ms = timed_build(fixed_model, keys);
+
+    auto as_is = [](const auto& key) { return key; };
+    double preformatted_mops = fixedKeyLookupMops(string_model, formatted, as_is);
+    double string_mops = fixedKeyLookupMops(string_model, keys, format);
+    double fixed_mops = fixedKeyLookupMops(fixed_model, keys, as_is);
+
+    std::cout << std::left << std::setw(28) << name << std::fixed << std::setprecision(1)
+              << "build " << std::setw(8) << string_build_ms << " -> " << std::setw(8) << fixed_build_ms << " ms   "
+              << "lookup " << std::setprecision(2) << string_mops << " (" << preformatted_mops
+              << " preformatted) -> " << fixed_mops << " Mops/s\n";
+    csv << name << "," << keys.size() << "," << string_build_ms << "," << fixed_build_ms << ","
+        << string_mops << "," << preformatted_mops << "," << fixed_mops << "\n";
+}
+
+// Celobrojni ID-jevi i 16-bajtni UUID-jevi: modeli nad stringovima (kljuc
+// formatiran kao tekst) naspram modela nad tipiziranim kljucevima
+void benchmarkFixedKeys() {
+    const size_t n = 1000000;
+    std::mt19937_64 rng(42);
+    std::vector<uint64_t> ids(n);
+    std::vector<Uuid> uuids(n);
+    for (size_t i = 0; i < n; i++) {
+        ids[i] = rng();
+        for (uint8_t& b : uuids[i]) b = static_cast<uint8_t>(rng());
+    }
+
+    std::ofstream csv("fixed_key_results.csv");
+    csv << "Model,Num_Keys,String_Build_Ms,Fixed_Build_Ms,String_Lookup_Mops,"
+           "Preformatted_Lookup_Mops,Fixed_Lookup_Mops\n";
+    std::cout << "=== Integer and UUID keys: string model -> fixed-key model (" << n << " keys) ===\n";
+
+    auto id_text = [](uint64_t id) { return std::to_string(id); };
+    using StringBDZ = HybridPipeline<SipHash24Preprocessor, NoFilter, BDZIndex, NoVerifier>;
+    compareFixedKeys<StringBDZ, FixedKeyBDZ<uint64_t>>("BDZ, uint64 IDs", ids, id_text, csv);
+    compareFixedKeys<UltimateHybridHash, FixedKeyUltimate<uint64_t>>("Ultimate, uint64 IDs", ids, id_text, csv);
+    compareFixedKeys<StringBDZ, FixedKeyBDZ<Uuid>>("BDZ, UUIDs", uuids, formatUuid, csv);
+    compareFixedKeys<UltimateHybridHash, FixedKeyUltimate<Uuid>>("Ultimate, UUIDs", uuids, formatUuid, csv);
+
+    std::cout << "\nRezultati sacuvani u: fixed_key_results.csv\n";
+}
+
+// Sortiran recnik: rang kljuca iz monotonog MPHF-a naspram BDZ pipeline-a
+// sa 32-bitnim nizom rangova po slotu. Bitovi po kljucu i ns po lookup-u.
+void benchmarkMonotone() {
+    std::ofstream csv("monotone_results.csv");
+    csv << "Model,Num_Keys,Bits_Per_Key,Build_Ms,Ns_Per_Lookup\n";
+    std::cout << "=== Sorted keys: rank lookup ===\n";
+
+    for (size_t n : {100000, 1000000}) {
+        std::vector<std::string> keys = generateKeys(n);
+        std::sort(keys.begin(), keys.end());
+
+        // Kljucevi se traze nasumicnim redom, kao u recniku
+        std::vector<std::string> queries = keys;
+        std::shuffle(queries.begin(), queries.end(), std::mt19937_64(7));
+
+        auto report = [&](const std::string& name, size_t bytes, double build_ms, double lookup_sec) {
+            double bits = bytes * 8.0 / n;
+            double ns = lookup_sec * 1e9 / n;
+            std::cout << std::left << std::setw(36) << name << std::setw(10) << n << std::fixed
+                      << std::setprecision(2) << bits << " bits/key   build " << std::setprecision(0)
+                      << build_ms << " ms   " << std::setprecision(1) << ns << " ns/lookup\n";
+            csv << name << "," << n << "," << bits << "," << build_ms << "," << ns << "\n";
+        };
+
+        MonotoneMPHF monotone;
+        auto start = std::chrono::high_resolution_clock::now();
+        monotone.build(keys);
+        auto built = std::chrono::high_resolution_clock::now();
+        uint64_t checksum = lookupChecksum(monotone, queries);
+        auto end = std::chrono::high_resolution_clock::now();
+        benchmark_sink = benchmark_sink ^ checksum;
+        report("Monotone MPHF", monotone.getMemoryUsage(),
+               std::chrono::duration<double, std::milli>(built - start).count(),
+               std::chrono::duration<double>(end - built).count());
+
+        // MPHF + niz rangova indeksiran slotom
+        HybridPipeline<SipHash24Preprocessor, NoFilter, BDZIndex, NoVerifier> mphf;
+        start = std::chrono::high_resolution_clock::now();
+        mphf.build(keys);
+        std::vector<uint32_t> ranks(static_cast<size_t>(n * 1.3) + 64);
+        for (size_t i = 0; i < n; i++) {
+            uint64_t slot = mphf.hash(keys[i]);
+            if (slot >= ranks.size()) ranks.resize(slot + 1);
+            ranks[slot] = static_cast<uint32_t>(i);
+        }
+        built = std::chrono::high_resolution_clock::now();
+        const size_t group = 64;
+        uint64_t slots[group];
+        checksum = 0;
+        for (size_t begin = 0; begin < n; begin += group) {
+            size_t count = std::min(group, n - begin);
+            mphf.hashBatch(queries.data() + begin, count, slots);
+            for (size_t i = 0; i < count; i++) {
+                checksum ^= ranks[slots[i]];
+            }
+        }
+        end = std::chrono::high_resolution_clock::now();
+        benchmark_sink = benchmark_sink ^ checksum;
+        report("BDZ MPHF + 32-bit rank array", mphf.getMemoryUsage() + ranks.size() * sizeof(uint32_t),
+               std::chrono::duration<double, std::milli>(built - start).count(),
+               std::chrono::duration<double>(end - built).count());
+    }
+    std::cout << "\nRezultati sacuvani u: monotone_results.csv\n";
+}
+
+// Stranice za velike nizove indeksa: jedan mod, ili "compare" (4K pa THP)
+struct PageMode {
+    HugePages policy;
+    std::string label;  // Prazno: ime modela bez oznake
+};
+
+// Parsira argumente; --numa, --preprocessors, --fixed-keys i --monotone
+// postavljaju svoje zastavice
+std::vector<PageMode> parseArgs(int argc, char** argv) {
+    std::vector<PageMode> modes = {{hugePages(), ""}};
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--numa") {
+            numa_compare = true;
+            continue;
+        }
+        if (arg == "--preprocessors") {
+            preprocessor_sweep = true;
+            continue;
+        }
+        if (arg == "--fixed-keys") {
+            fixed_key_sweep = true;
+            continue;
+        }
+        if (arg == "--monotone") {
+            monotone_sweep = true;
+            continue;
+        }
+        if (arg != "--huge-pages" || i + 1 >= argc) {
+            throw std::invalid_argument(
+                "Usage: throughput_benchmark [--huge-pages off|thp|hugetlb|compare] [--numa] [--preprocessors] [--fixed-keys] "
+                "[--monotone]");
+        }
+        std::string mode = argv[++i];
+        if (mode == "off") {
+            modes = {{HugePages::OFF, " [4K pages]"}};
+        } else if (mode == "thp") {
+            modes = {{HugePages::TRANSPARENT, " [THP]"}};
+        } else if (mode == "hugetlb") {
+            modes = {{HugePages::EXPLICIT, " [hugetlb]"}};
+        } else if (mode == "compare") {
+            modes = {{HugePages::OFF, " [4K pages]"}, {HugePages::TRANSPARENT, " [THP]"}};
+        } else {
+            throw std::invalid_argument("Unknown --huge-pages mode: " + mode);
+        }
+    }
+    return modes;
+}
+
+int main(int argc, char** argv) {
+    std::vector<PageMode> page_modes;
+    try {
+        page_modes = parseArgs(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    if (preprocessor_sweep) {
+        benchmarkPreprocessors();
+        return 0;
+    }
+    if (fixed_key_sweep) {
+        benchmarkFixedKeys();
+        return 0;
+    }
+    if (monotone_sweep) {
+        benchmarkMonotone();
+        return 0;
+    }
+    if (numa_compare && NumaTopology::system().numNodes() < 2) {
+        std::cout << "Single NUMA node: --numa comparison skipped\n";
+        numa_compare = false;
+    }
+
     std::cout << "=================================================================\n";
     std::cout << "         HASH ALGORITHM THROUGHPUT BENCHMARK\n";
     std::cout << "=================================================================\n\n";
@@ -40,6 +543,22 @@ int main() {
     // Test veličine: 1k, 10k, 100k, 1M, 5M, 10M
     std::vector<size_t> key_sizes = {1000, 10000, 100000, 1000000, 5000000, 10000000};
     
+    // Svih 12 algoritama
+    const std::vector<ModelBenchmark> algorithms = {
+        benchmarkModel<BasicPerfectHash>,
+        benchmarkModel<BasicCryptoHash>,
+        benchmarkModel<BDZ_MPHF>,
+        benchmarkModel<CuckooPerfectHash>,
+        benchmarkModel<UltimateHybridHash>,
+        benchmarkModel<AdaptiveSecurityHybrid>,
+        benchmarkModel<ParallelVerificationHybrid>,
+        benchmarkModel<CachePartitionedHybrid>,
+        benchmarkModel<UltraLowMemoryHybrid>,
+        benchmarkModel<TwoPathHybrid>,
+        benchmarkModel<HybridCryptoPerfect>,
+        benchmarkModel<HybridPerfectVerify>,
+    };
+    
     // CSV fajl za izlaz
     std::ofstream csv("benchmark_results.csv");
     csv << "Algorithm,Num_Keys,Insert_Ops_Per_Sec,Lookup_Ops_Per_Sec,Memory_Usage_MB,Efficiency_Ops_Per_MB\n";
@@ -51,76 +570,12 @@ int main() {
         std::cout << "Generisanje kljuceva...\n";
         std::vector<std::string> keys = generateKeys(size);
         
-        // Testiranje svih 9 algoritama
-        std::vector<std::unique_ptr<HashModel>> algorithms;
-        algorithms.push_back(std::make_unique<BasicPerfectHash>());
-        algorithms.push_back(std::make_unique<BasicCryptoHash>());
-        algorithms.push_back(std::make_unique<BDZ_MPHF>());
-        algorithms.push_back(std::make_unique<UltimateHybridHash>());
-        algorithms.push_back(std::make_unique<AdaptiveSecurityHybrid>());
-        algorithms.push_back(std::make_unique<ParallelVerificationHybrid>());
-        algorithms.push_back(std::make_unique<CachePartitionedHybrid>());
-        algorithms.push_back(std::make_unique<UltraLowMemoryHybrid>());
-        algorithms.push_back(std::make_unique<TwoPathHybrid>());
-        
         int count = 0;
-        for (auto& algo : algorithms) {
-            count++;
-            std::cout << "[" << count << "/9] " << std::setw(40) << std::left 
-                      << algo->getName() << " ... ";
-            std::cout.flush();
-            
-            try {
-                // === BULK INSERT ===
-                auto insert_start = std::chrono::high_resolution_clock::now();
-                algo->build(keys);
-                auto insert_end = std::chrono::high_resolution_clock::now();
-                
-                double insert_sec = std::chrono::duration<double>(insert_end - insert_start).count();
-                double insert_mops = (size / insert_sec) / 1e6;
-                
-                // === BULK LOOKUP ===
-                auto lookup_start = std::chrono::high_resolution_clock::now();
-                for (const auto& key : keys) {
-                    volatile uint64_t hash_val = algo->hash(key);
-                    (void)hash_val;
-                }
-                auto lookup_end = std::chrono::high_resolution_clock::now();
-                
-                double lookup_sec = std::chrono::duration<double>(lookup_end - lookup_start).count();
-                double lookup_mops = (size / lookup_sec) / 1e6;
-                
-                // === MEMORY ===
-                double memory_mb = algo->getMemoryUsage() / (1024.0 * 1024.0);
-                
-                // === EFFICIENCY: Lookup throughput per MB ===
-                double efficiency = (memory_mb > 0.0) ? (lookup_mops / memory_mb) : 0.0;
-                
-                // Ispis
-                std::cout << "Insert: " << std::fixed << std::setprecision(2) 
-                          << insert_mops << " Mops/s, "
-                          << "Lookup: " << lookup_mops << " Mops/s, "
-                          << "Mem: " << memory_mb << " MB, "
-                          << "Eff: " << efficiency << " Ops/MB\n";
-                
-                // Upis u CSV
-                csv << std::fixed << std::setprecision(6)
-                    << algo->getName() << ","
-                    << size << ","
-                    << insert_mops << ","
-                    << lookup_mops << ","
-                    << std::setprecision(3) << memory_mb << ","
-                    << std::setprecision(6) << efficiency << "\n";
-                csv.flush(); // Flush nakon svakog testa
-                
-            } catch (const std::exception& e) {
-                std::cout << "FAILED: " << e.what() << "\n";
-                
-                // Upisivanje neuspelog testa
-                csv << algo->getName() << ","
-                    << size << ","
-                    << "0.0,0.0,0.0,0.0\n";
-                csv.flush();
+        for (ModelBenchmark run : algorithms) {
+            ++count;
+            for (const PageMode& mode : page_modes) {
+                setHugePages(mode.policy);
+                run(keys, count, static_cast<int>(algorithms.size()), csv, mode.label);
             }
         }
     }
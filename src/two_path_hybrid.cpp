@@ -1,448 +1,296 @@
 #include "two_path_hybrid.hpp"
-#include "murmur_hash.hpp"
-#include <random>
+#include "parallel.hpp"
+#include "duplicate_keys.hpp"
+#include "serialization.hpp"
 #include <iostream>
 #include <iomanip>
-#include <cstring>
 #include <algorithm>
-#include <queue>
-#include <array>
+#include <cmath>
+#include <stdexcept>
 
 namespace hashing {
 
-#define ROTL(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
-#define ROTL32(x, b) (uint32_t)(((x) << (b)) | ((x) >> (32 - (b))))
-#define SIPROUND \
-    do { \
-        v0 += v1; v1 = ROTL(v1, 13); v1 ^= v0; v0 = ROTL(v0, 32); \
-        v2 += v3; v3 = ROTL(v3, 16); v3 ^= v2; \
-        v0 += v3; v3 = ROTL(v3, 21); v3 ^= v0; \
-        v2 += v1; v1 = ROTL(v1, 17); v1 ^= v2; v2 = ROTL(v2, 32); \
-    } while(0)
-
-bool TwoPathHybrid::route_to_secure_lane(const std::string& key) const {
-    // Deterministic routing: use LSB of hash
-    uint64_t h = fast_siphash(key);
-    return (h & 0x01) != 0;
+bool TwoPathHybrid::route_to_secure_lane(uint64_t fast_hash) const {
+    if (route_cells == 0) {
+        // Deterministic routing: use LSB of the fast lane hash
+        return (fast_hash & 0x01) != 0;
+    }
+    uint64_t cell = route_cell(fast_hash);
+    return (route_bits[cell / 64] & (uint64_t(1) << (cell % 64))) == 0;
 }
 
-uint64_t TwoPathHybrid::fast_siphash(const std::string& key) const {
-    const uint8_t* in = reinterpret_cast<const uint8_t*>(key.data());
-    size_t inlen = key.size();
-    
-    uint64_t v0 = 0x736f6d6570736575ULL ^ fast_sip_key0;
-    uint64_t v1 = 0x646f72616e646f6dULL ^ fast_sip_key1;
-    uint64_t v2 = 0x6c7967656e657261ULL ^ fast_sip_key0;
-    uint64_t v3 = 0x7465646279746573ULL ^ fast_sip_key1;
-    uint64_t b = ((uint64_t)inlen) << 56;
-    
-    const uint8_t* end = in + inlen - (inlen % sizeof(uint64_t));
-    for (; in != end; in += 8) {
-        uint64_t m;
-        std::memcpy(&m, in, sizeof(m));
-        v3 ^= m;
-        SIPROUND; // Only 1 round (SipHash-1-2)
-        v0 ^= m;
-    }
-    
-    const int left = inlen & 7;
-    switch (left) {
-        case 7: b |= ((uint64_t)in[6]) << 48; [[fallthrough]];
-        case 6: b |= ((uint64_t)in[5]) << 40; [[fallthrough]];
-        case 5: b |= ((uint64_t)in[4]) << 32; [[fallthrough]];
-        case 4: b |= ((uint64_t)in[3]) << 24; [[fallthrough]];
-        case 3: b |= ((uint64_t)in[2]) << 16; [[fallthrough]];
-        case 2: b |= ((uint64_t)in[1]) << 8; [[fallthrough]];
-        case 1: b |= ((uint64_t)in[0]); break;
-        case 0: break;
-    }
-    
-    v3 ^= b;
-    SIPROUND;
-    v0 ^= b;
-    v2 ^= 0xff;
-    SIPROUND; SIPROUND; // 2 finalization rounds
-    
-    return v0 ^ v1 ^ v2 ^ v3;
+// The fast lane's BDZ reads the same hash; the bitmap takes a remix of it
+// onto [0, route_cells) by multiply-shift
+uint64_t TwoPathHybrid::route_cell(uint64_t fast_hash) const {
+    uint64_t lo, hi;
+    detail::mul128(MurmurHash3::fmix64(fast_hash ^ 0x452821e638d01377ULL), route_cells, lo, hi);
+    return hi;
 }
 
-uint64_t TwoPathHybrid::secure_siphash(const std::string& key) const {
-    const uint8_t* in = reinterpret_cast<const uint8_t*>(key.data());
-    size_t inlen = key.size();
-    
-    uint64_t v0 = 0x736f6d6570736575ULL ^ secure_sip_key0;
-    uint64_t v1 = 0x646f72616e646f6dULL ^ secure_sip_key1;
-    uint64_t v2 = 0x6c7967656e657261ULL ^ secure_sip_key0;
-    uint64_t v3 = 0x7465646279746573ULL ^ secure_sip_key1;
-    uint64_t b = ((uint64_t)inlen) << 56;
-    
-    const uint8_t* end = in + inlen - (inlen % sizeof(uint64_t));
-    for (; in != end; in += 8) {
-        uint64_t m;
-        std::memcpy(&m, in, sizeof(m));
-        v3 ^= m;
-        SIPROUND; SIPROUND; // 2 rounds (SipHash-2-4)
-        v0 ^= m;
+void TwoPathHybrid::build_router(const std::vector<uint64_t>& fast_hashes, const std::vector<double>& weights,
+                                 const std::vector<uint8_t>& sensitive) {
+    size_t n = fast_hashes.size();
+    std::vector<size_t> hot;
+    for (size_t i = 0; i < n; i++) {
+        if (sensitive.empty() || !sensitive[i]) hot.push_back(i);
     }
-    
-    const int left = inlen & 7;
-    switch (left) {
-        case 7: b |= ((uint64_t)in[6]) << 48; [[fallthrough]];
-        case 6: b |= ((uint64_t)in[5]) << 40; [[fallthrough]];
-        case 5: b |= ((uint64_t)in[4]) << 32; [[fallthrough]];
-        case 4: b |= ((uint64_t)in[3]) << 24; [[fallthrough]];
-        case 3: b |= ((uint64_t)in[2]) << 16; [[fallthrough]];
-        case 2: b |= ((uint64_t)in[1]) << 8; [[fallthrough]];
-        case 1: b |= ((uint64_t)in[0]); break;
-        case 0: break;
+    if (!weights.empty()) {
+        size_t target = std::min(hot.size(), static_cast<size_t>(std::llround(fast_lane_share * n)));
+        std::nth_element(hot.begin(), hot.begin() + target, hot.end(),
+                         [&](size_t a, size_t b) { return weights[a] > weights[b]; });
+        hot.resize(target);
     }
-    
-    v3 ^= b;
-    SIPROUND; SIPROUND;
-    v0 ^= b;
-    v2 ^= 0xff;
-    SIPROUND; SIPROUND; SIPROUND; SIPROUND; // 4 finalization rounds
-    
-    return v0 ^ v1 ^ v2 ^ v3;
-}
 
-uint64_t TwoPathHybrid::blake3_stage(const std::string& key) const {
-    const uint32_t IV[8] = {
-        0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
-        0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
-    };
-
-    uint32_t state[8];
-    std::memcpy(state, IV, sizeof(state));
-
-    // Improved mixing with multiple rounds for better avalanche effect
-    for (size_t i = 0; i < key.size(); i++) {
-        uint32_t c = static_cast<uint32_t>(key[i]);
-        size_t idx = i % 8;
-        state[idx] ^= c;
-        state[(idx + 1) % 8] ^= ROTL32(state[idx], 7);
-        state[(idx + 2) % 8] ^= ROTL32(state[idx], 13);
-        state[(idx + 3) % 8] ^= ROTL32(state[idx], 16);
+    route_cells = std::max<uint64_t>(64, (hot.size() * ROUTE_CELLS_PER_HOT_KEY + 63) / 64 * 64);
+    route_bits.assign(route_cells / 64, 0);
+    for (size_t i : hot) {
+        uint64_t cell = route_cell(fast_hashes[i]);
+        route_bits[cell / 64] |= uint64_t(1) << (cell % 64);
     }
-
-    // Final mixing round
-    for (int i = 0; i < 8; i++) {
-        state[i] = ROTL32(state[i], 11) ^ state[(i + 1) % 8];
+    // A sensitive key's cell stays clear, whichever hot keys share it
+    for (size_t i = 0; i < sensitive.size(); i++) {
+        if (!sensitive[i]) continue;
+        uint64_t cell = route_cell(fast_hashes[i]);
+        route_bits[cell / 64] &= ~(uint64_t(1) << (cell % 64));
     }
 
-    // Use XOR of all state words
-    uint64_t result = 0;
-    for (int i = 0; i < 8; i++) {
-        result ^= static_cast<uint64_t>(state[i]) << ((i % 2) * 32);
+    hot_keys = hot.size();
+    demoted_keys = 0;
+    for (size_t i : hot) {
+        if (route_to_secure_lane(fast_hashes[i])) demoted_keys++;
     }
-    return result;
-}
-
-void TwoPathHybrid::compute_mphf_hashes(uint64_t preprocessed, const uint64_t seeds[3],
-                                        size_t table_sz, size_t& h0, size_t& h1, size_t& h2) const {
-    // Use MurmurHash3 for high-quality, independent hash functions
-    std::string preprocessed_str = std::to_string(preprocessed);
-    MurmurHash3::hash_triple(preprocessed_str, seeds[0], seeds[1], seeds[2],
-                             h0, h1, h2, table_sz);
-}
-
-size_t TwoPathHybrid::fast_mphf(uint64_t preprocessed) const {
-    size_t h0, h1, h2;
-    compute_mphf_hashes(preprocessed, fast_seeds, fast_table_size, h0, h1, h2);
-    
-    auto get_g = [this](size_t v) -> uint8_t {
-        size_t byte_idx = v / 4;
-        size_t bit_offset = (v % 4) * 2;
-        return (fast_g_table[byte_idx] >> bit_offset) & 0x03;
-    };
-    
-    uint8_t g0 = get_g(h0);
-    uint8_t g1 = get_g(h1);
-    uint8_t g2 = get_g(h2);
-    
-    return (g0 + g1 + g2) % (num_keys / 2); // Approx half keys
 }
 
-size_t TwoPathHybrid::secure_mphf(uint64_t preprocessed) const {
-    size_t h0, h1, h2;
-    compute_mphf_hashes(preprocessed, secure_seeds, secure_table_size, h0, h1, h2);
-    
-    auto get_g = [this](size_t v) -> uint8_t {
-        size_t byte_idx = v / 4;
-        size_t bit_offset = (v % 4) * 2;
-        return (secure_g_table[byte_idx] >> bit_offset) & 0x03;
-    };
-    
-    uint8_t g0 = get_g(h0);
-    uint8_t g1 = get_g(h1);
-    uint8_t g2 = get_g(h2);
-    
-    return (g0 + g1 + g2) % (num_keys / 2 + num_keys % 2);
-}
-
-bool TwoPathHybrid::build_mphf(const std::vector<std::string>& keys, std::vector<uint8_t>& g_table,
-                               size_t table_sz, const uint64_t seeds[3], uint64_t sip_k0, uint64_t sip_k1) {
-    size_t n = keys.size();
-    std::vector<std::vector<size_t>> edges(table_sz);
-    std::vector<std::array<size_t, 3>> key_edges(n);
-    
-    auto siphash_local = [&](const std::string& key) -> uint64_t {
-        const uint8_t* in = reinterpret_cast<const uint8_t*>(key.data());
-        size_t inlen = key.size();
-        
-        uint64_t v0 = 0x736f6d6570736575ULL ^ sip_k0;
-        uint64_t v1 = 0x646f72616e646f6dULL ^ sip_k1;
-        uint64_t v2 = 0x6c7967656e657261ULL ^ sip_k0;
-        uint64_t v3 = 0x7465646279746573ULL ^ sip_k1;
-        uint64_t b = ((uint64_t)inlen) << 56;
-        
-        const uint8_t* end = in + inlen - (inlen % sizeof(uint64_t));
-        for (; in != end; in += 8) {
-            uint64_t m;
-            std::memcpy(&m, in, sizeof(m));
-            v3 ^= m;
-            SIPROUND; SIPROUND;
-            v0 ^= m;
-        }
-        
-        const int left = inlen & 7;
-        switch (left) {
-            case 7: b |= ((uint64_t)in[6]) << 48; [[fallthrough]];
-            case 6: b |= ((uint64_t)in[5]) << 40; [[fallthrough]];
-            case 5: b |= ((uint64_t)in[4]) << 32; [[fallthrough]];
-            case 4: b |= ((uint64_t)in[3]) << 24; [[fallthrough]];
-            case 3: b |= ((uint64_t)in[2]) << 16; [[fallthrough]];
-            case 2: b |= ((uint64_t)in[1]) << 8; [[fallthrough]];
-            case 1: b |= ((uint64_t)in[0]); break;
-            case 0: break;
-        }
-        
-        v3 ^= b;
-        SIPROUND; SIPROUND;
-        v0 ^= b;
-        v2 ^= 0xff;
-        SIPROUND; SIPROUND; SIPROUND; SIPROUND;
-        
-        return v0 ^ v1 ^ v2 ^ v3;
-    };
-    
-    for (size_t i = 0; i < n; i++) {
-        uint64_t preprocessed = siphash_local(keys[i]);
-        size_t h0, h1, h2;
-        compute_mphf_hashes(preprocessed, seeds, table_sz, h0, h1, h2);
-        
-        key_edges[i][0] = h0;
-        key_edges[i][1] = h1;
-        key_edges[i][2] = h2;
-        edges[h0].push_back(i);
-        edges[h1].push_back(i);
-        edges[h2].push_back(i);
-    }
-    
-    std::queue<size_t> queue;
-    std::vector<int> degree(table_sz);
-    
-    for (size_t v = 0; v < table_sz; v++) {
-        degree[v] = static_cast<int>(edges[v].size());
-        if (degree[v] == 1) queue.push(v);
-    }
-    
-    std::vector<bool> visited(n, false);
-    std::vector<size_t> ordering;
-    
-    while (!queue.empty()) {
-        size_t v = queue.front();
-        queue.pop();
-        
-        if (degree[v] == 0) continue;
-        
-        size_t key_idx = table_sz;
-        for (size_t k : edges[v]) {
-            if (!visited[k]) {
-                key_idx = k;
-                break;
-            }
-        }
-        
-        if (key_idx == table_sz) continue;
-        
-        visited[key_idx] = true;
-        ordering.push_back(key_idx);
-        
-        for (size_t j = 0; j < 3; j++) {
-            size_t vertex = key_edges[key_idx][j];
-            degree[vertex]--;
-            if (degree[vertex] == 1) queue.push(vertex);
+void TwoPathHybrid::hash_keys(const std::vector<std::string>& keys, std::mt19937_64& gen,
+                              KeySignatures& all, std::vector<uint8_t>& secure,
+                              const std::vector<double>* weights, const std::vector<uint8_t>* sensitive) {
+    fast_lane.configure(build_config);
+    secure_lane.configure(build_config);
+    fast_lane.reseed(gen);
+    secure_lane.reseed(gen);
+
+    // Index hash is the lane's SipHash; fingerprints only matter for the secure lane
+    secure.assign(keys.size(), 0);
+    all = KeySignatures();
+    all.index_hashes.resize(keys.size());
+    all.fingerprints.resize(keys.size());
+
+    parallel_for(keys.size(), build_config.num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            all.index_hashes[i] = fast_lane.preprocess(keys[i]);
         }
+    });
+
+    route_bits.clear();
+    route_cells = 0;
+    hot_keys = demoted_keys = 0;
+    if (weights || sensitive) {
+        static const std::vector<double> no_weights;
+        static const std::vector<uint8_t> no_flags;
+        build_router(all.index_hashes, weights ? *weights : no_weights, sensitive ? *sensitive : no_flags);
     }
-    
-    if (ordering.size() != n) return false;
-    
-    std::vector<int> assigned(table_sz, -1);
-    g_table.clear();
-    g_table.resize((table_sz + 3) / 4, 0);
-    
-    for (auto it = ordering.rbegin(); it != ordering.rend(); ++it) {
-        size_t key_idx = *it;
-        auto& edge = key_edges[key_idx];
-        
-        for (uint8_t g = 0; g < 3; g++) {
-            size_t sum = 0;
-            for (size_t j = 0; j < 3; j++) {
-                size_t v = edge[j];
-                if (assigned[v] == -1) {
-                    assigned[v] = g;
-                    size_t byte_idx = v / 4;
-                    size_t bit_offset = (v % 4) * 2;
-                    g_table[byte_idx] |= (g & 0x03) << bit_offset;
-                    sum += g;
-                    break;
-                } else {
-                    sum += assigned[v];
-                }
+
+    parallel_for(keys.size(), build_config.num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            secure[i] = route_to_secure_lane(all.index_hashes[i]);
+            if (secure[i]) {
+                all.index_hashes[i] = secure_lane.preprocess(keys[i]);
+                all.fingerprints[i] = secure_lane.fingerprint(keys[i]);
+            } else {
+                all.fingerprints[i] = 0;
             }
-            if ((sum % 3) == (key_idx % 3)) break;
         }
-    }
-    
-    return true;
+    });
 }
 
-double TwoPathHybrid::compute_chi_square(const std::vector<std::string>& keys) const {
-    std::vector<size_t> bucket_counts(num_keys, 0);
-
-    for (const auto& key : keys) {
-        uint64_t h = hash(key);
-        if (h < num_keys) {
-            bucket_counts[h]++;
+bool TwoPathHybrid::build_lanes(const KeySignatures& all, const std::vector<uint8_t>& secure,
+                                std::mt19937_64& gen) {
+    num_keys = all.size();
+    KeySignatures fast_sigs, secure_sigs;
+    for (size_t i = 0; i < num_keys; i++) {
+        if (secure[i]) {
+            secure_sigs.index_hashes.push_back(all.index_hashes[i]);
+            secure_sigs.fingerprints.push_back(all.fingerprints[i]);
+        } else {
+            fast_sigs.index_hashes.push_back(all.index_hashes[i]);
         }
     }
 
-    double expected = static_cast<double>(keys.size()) / num_keys;
-    double chi_square = 0.0;
+    bool fast_success = fast_lane.buildFromSignatures(fast_sigs, gen);
+    bool secure_success = secure_lane.buildFromSignatures(secure_sigs, gen);
 
-    for (size_t count : bucket_counts) {
-        double diff = count - expected;
-        chi_square += (diff * diff) / expected;
-    }
+    construction_stats = ConstructionStats();
+    construction_stats.attempts = fast_lane.getConstructionStats().attempts +
+                                  secure_lane.getConstructionStats().attempts;
+    construction_stats.fallback_keys = fast_lane.getConstructionStats().fallback_keys +
+                                       secure_lane.getConstructionStats().fallback_keys;
+    construction_stats.success = fast_success && secure_success;
+    return construction_stats.success;
+}
 
-    return chi_square;
+// As HybridPipeline: repeated keys are reported, or dropped and both lanes
+// built again. Fast lane signatures hold only the SipHash, so repeats are
+// confirmed on the keys.
+void TwoPathHybrid::build_without_repeats(KeySignatures& all, std::vector<uint8_t>& secure, std::mt19937_64& gen,
+                                          const std::vector<std::string>& keys) {
+    if (build_lanes(all, secure, gen) ||
+        !(fast_lane.indexStage().equalSignatures() || secure_lane.indexStage().equalSignatures())) {
+        return;
+    }
+    std::vector<size_t> repeats = findDuplicateKeys(keys, build_config.num_threads);
+    if (repeats.empty()) {
+        std::cerr << "Warning: " << getName() << ": distinct keys share a preprocessed hash; "
+                  << "rebuild with another seed\n";
+        return;
+    }
+    size_t attempts = construction_stats.attempts;
+    if (build_config.deduplicate) {
+        eraseDuplicates(all.index_hashes, repeats);
+        eraseDuplicates(all.fingerprints, repeats);
+        eraseDuplicates(secure, repeats);
+        build_lanes(all, secure, gen);
+        construction_stats.attempts += attempts;
+    }
+    reportDuplicates(construction_stats, repeats, getName(), build_config.deduplicate);
 }
 
 void TwoPathHybrid::build(const std::vector<std::string>& keys) {
-    num_keys = keys.size();
-    fast_table_size = static_cast<size_t>(1.23 * (num_keys / 2));
-    secure_table_size = static_cast<size_t>(1.23 * (num_keys / 2 + num_keys % 2));
-
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-
-    fast_sip_key0 = gen();
-    fast_sip_key1 = gen();
-    fast_seeds[0] = gen();
-    fast_seeds[1] = gen();
-    fast_seeds[2] = gen();
-
-    secure_sip_key0 = gen();
-    secure_sip_key1 = gen();
-    secure_seeds[0] = gen();
-    secure_seeds[1] = gen();
-    secure_seeds[2] = gen();
-
-    // Initialize construction statistics
-    construction_stats = ConstructionStats();
-
-    // Split keys into two lanes
-    std::vector<std::string> fast_keys, secure_keys;
-    for (const auto& key : keys) {
-        if (route_to_secure_lane(key)) {
-            secure_keys.push_back(key);
-        } else {
-            fast_keys.push_back(key);
-        }
+    std::mt19937_64 gen = build_rng();
+
+    KeySignatures all;
+    std::vector<uint8_t> secure;
+    hash_keys(keys, gen, all, secure);
+    build_without_repeats(all, secure, gen, keys);
+    if (build_config.exact && construction_stats.success) {
+        store_keys(keys);
     }
+}
 
-    // Build fast lane MPHF
-    bool fast_success = false;
-    for (int attempt = 0; attempt < 100 && !fast_success; attempt++) {
-        construction_stats.attempts++;
-        fast_success = build_mphf(fast_keys, fast_g_table, fast_table_size, fast_seeds,
-                           fast_sip_key0, fast_sip_key1);
-        if (!fast_success) {
-            fast_seeds[0] = gen();
-            fast_seeds[1] = gen();
-            fast_seeds[2] = gen();
-        }
+void TwoPathHybrid::buildWeighted(const std::vector<std::string>& keys, const std::vector<double>& weights,
+                                  const std::vector<uint8_t>& sensitive) {
+    if ((!weights.empty() && weights.size() != keys.size()) ||
+        (!sensitive.empty() && sensitive.size() != keys.size())) {
+        throw std::invalid_argument("Lane weights and sensitive flags need one entry per key");
     }
-
-    // Build secure lane MPHF
-    bool secure_success = false;
-    for (int attempt = 0; attempt < 100 && !secure_success; attempt++) {
-        construction_stats.attempts++;
-        secure_success = build_mphf(secure_keys, secure_g_table, secure_table_size, secure_seeds,
-                           secure_sip_key0, secure_sip_key1);
-        if (!secure_success) {
-            secure_seeds[0] = gen();
-            secure_seeds[1] = gen();
-            secure_seeds[2] = gen();
-        }
+    std::mt19937_64 gen = build_rng();
+
+    KeySignatures all;
+    std::vector<uint8_t> secure;
+    hash_keys(keys, gen, all, secure, &weights, &sensitive);
+    build_without_repeats(all, secure, gen, keys);
+    if (build_config.exact && construction_stats.success) {
+        store_keys(keys);
     }
+}
 
-    construction_stats.success = fast_success && secure_success;
-
-    // Build verification fingerprints for secure lane only
-    secure_fingerprints.resize(secure_keys.size());
-    for (size_t i = 0; i < secure_keys.size(); i++) {
-        secure_fingerprints[i] = blake3_stage(secure_keys[i]);
+void TwoPathHybrid::setFastLaneShare(double share) {
+    if (!(share >= 0.0 && share <= 1.0)) {
+        throw std::invalid_argument("Fast lane share must be in [0, 1]");
     }
+    fast_lane_share = share;
+}
 
-    // Compute chi-square for successful builds
-    if (construction_stats.success) {
-        construction_stats.chi_square = compute_chi_square(keys);
+// Exact mode: each lane stores its own keys at its own slots
+void TwoPathHybrid::store_keys(const std::vector<std::string>& keys) {
+    std::vector<uint8_t> secure(keys.size());
+    parallel_for(keys.size(), build_config.num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            secure[i] = route_to_secure_lane(fast_lane.preprocess(keys[i]));
+        }
+    });
+    std::vector<size_t> fast_positions, secure_positions;
+    for (size_t i = 0; i < keys.size(); i++) {
+        (secure[i] ? secure_positions : fast_positions).push_back(i);
     }
+    fast_lane.storeKeys(fast_positions.size(),
+                        [&](size_t j) -> const std::string& { return keys[fast_positions[j]]; });
+    secure_lane.storeKeys(secure_positions.size(),
+                          [&](size_t j) -> const std::string& { return keys[secure_positions[j]]; });
 }
 
 uint64_t TwoPathHybrid::hash(const std::string& key) const {
-    if (route_to_secure_lane(key)) {
+    uint64_t fast_hash = fast_lane.preprocess(key);
+    
+    if (route_to_secure_lane(fast_hash)) {
         // Secure lane: SipHash-2-4 + BDZ + BLAKE3
-        uint64_t preprocessed = secure_siphash(key);
-        size_t index = secure_mphf(preprocessed);
-        
-        uint64_t expected = secure_fingerprints[index];
-        uint64_t actual = blake3_stage(key);
-        
-        if (expected != actual) {
-            return UINT64_MAX;
-        }
-        
-        return index;
-    } else {
-        // Fast lane: SipHash-1-2 + Simple MPHF (no verification)
-        uint64_t preprocessed = fast_siphash(key);
-        return fast_mphf(preprocessed);
+        uint64_t index = secure_lane.lookup(key, secure_lane.preprocess(key));
+        return index == UINT64_MAX ? UINT64_MAX : fast_lane.numKeys() + index;
     }
+
+    // Fast lane: SipHash-1-2 + Simple MPHF (no verification)
+    return fast_lane.lookup(key, fast_hash);
 }
 
+#ifdef HASHING_COROUTINES
+LookupTask TwoPathHybrid::hashCoroutine(const std::string& key) const {
+    uint64_t fast_hash = fast_lane.preprocess(key);
+
+    if (route_to_secure_lane(fast_hash)) {
+        return secure_lane.lookupCoroutine(key, secure_lane.preprocess(key), fast_lane.numKeys());
+    }
+    return fast_lane.lookupCoroutine(key, fast_hash);
+}
+#endif
+
 size_t TwoPathHybrid::getMemoryUsage() const {
-    return fast_g_table.size() + 
-           secure_g_table.size() + 
-           secure_fingerprints.size() * sizeof(uint64_t) +
-           sizeof(*this);
+    // Lane usage already includes each lane object
+    return sizeof(*this) - sizeof(fast_lane) - sizeof(secure_lane) +
+           fast_lane.getMemoryUsage() + secure_lane.getMemoryUsage() +
+           route_bits.size() * sizeof(uint64_t);
+}
+
+void TwoPathHybrid::save(std::ostream& out) const {
+    io::write_pod<uint64_t>(out, num_keys);
+    io::write_pod<uint64_t>(out, route_cells);
+    io::write_vector(out, route_bits);
+    fast_lane.save(out);
+    secure_lane.save(out);
+}
+
+void TwoPathHybrid::load(std::istream& in) {
+    num_keys = io::read_pod<uint64_t>(in);
+    route_cells = io::read_pod<uint64_t>(in);
+    io::read_vector(in, route_bits);
+    if (route_cells % 64 != 0 || route_bits.size() != route_cells / 64) {
+        throw std::runtime_error("Corrupt two-path index: routing bitmap size");
+    }
+    hot_keys = demoted_keys = 0;
+    fast_lane.load(in);
+    secure_lane.load(in);
+    if (fast_lane.numKeys() + secure_lane.numKeys() != num_keys) {
+        throw std::runtime_error("Corrupt two-path index: lane sizes do not add up");
+    }
+    construction_stats = ConstructionStats();
+    construction_stats.success = true;
 }
 
 void TwoPathHybrid::printStats() const {
+    const FingerprintArray& fingerprints = secure_lane.verifierStage().fingerprints();
+
     std::cout << "  Architecture: Dual-Path (Fast: CHD-like | Secure: BDZ+BLAKE3)\n";
-    std::cout << "  Routing: Deterministic hash-based lane assignment\n";
-    std::cout << "  Fast Lane MPHF: " << fast_g_table.size() << " bytes\n";
-    std::cout << "  Secure Lane MPHF: " << secure_g_table.size() << " bytes\n";
-    std::cout << "  Secure Fingerprints: " << secure_fingerprints.size() * 8 << " bytes\n";
-    std::cout << "  Lane Distribution: ~50% fast / ~50% secure\n";
+    if (trafficAware()) {
+        std::cout << "  Routing: Traffic-aware bitmap (" << route_bits.size() * sizeof(uint64_t) << " bytes, "
+                  << route_cells << " cells, one probe)\n";
+        if (hot_keys > 0) {
+            std::cout << "  Hot keys: " << hot_keys << " (" << demoted_keys
+                      << " kept secure by a sensitive key's cell)\n";
+        }
+    } else {
+        std::cout << "  Routing: Deterministic hash-based lane assignment\n";
+    }
+    std::cout << "  Fast Lane MPHF: " << fast_lane.indexStage().sizeInBytes() << " bytes\n";
+    std::cout << "  Secure Lane MPHF: " << secure_lane.indexStage().sizeInBytes() << " bytes\n";
+    std::cout << "  Secure Fingerprints: " << fingerprints.sizeInBytes() << " bytes ("
+              << fingerprints.width() << " bits/key)\n";
+    std::cout << "  Lane Distribution: " << fast_lane.numKeys() << " fast / "
+              << secure_lane.numKeys() << " secure\n";
+    if (!fast_lane.keyStore().empty()) {
+        std::cout << "  Key arenas (exact): " << fast_lane.keyStore().sizeInBytes() << " bytes fast / "
+                  << secure_lane.keyStore().sizeInBytes() << " bytes secure\n";
+    }
 
     if (construction_stats.success) {
         std::cout << "  Construction attempts (both lanes): " << construction_stats.attempts << "\n";
-        std::cout << "  Chi-square statistic: " << std::fixed << std::setprecision(2)
-                  << construction_stats.chi_square << " (lower is better)\n";
-        std::cout << "  Expected chi-square for uniform: ~" << (num_keys - 1) << "\n";
     }
 }
 
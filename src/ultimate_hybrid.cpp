@@ -1,361 +1,26 @@
 #include "ultimate_hybrid.hpp"
-#include "murmur_hash.hpp"
-#include <random>
 #include <iostream>
 #include <iomanip>
-#include <cstring>
-#include <algorithm>
-#include <queue>
-#include <array>
-
-// MSVC ne podrzava __builtin_prefetch, definisemo praznu verziju
-#ifdef _MSC_VER
-    #define __builtin_prefetch(addr, rw, locality) ((void)0)
-#endif
+#include <cmath>
 
 namespace hashing {
 
-// SipHash implementation
-#define ROTL(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
-#define ROTL32(x, b) (uint32_t)(((x) << (b)) | ((x) >> (32 - (b))))
-#define SIPROUND \
-    do { \
-        v0 += v1; v1 = ROTL(v1, 13); v1 ^= v0; v0 = ROTL(v0, 32); \
-        v2 += v3; v3 = ROTL(v3, 16); v3 ^= v2; \
-        v0 += v3; v3 = ROTL(v3, 21); v3 ^= v0; \
-        v2 += v1; v1 = ROTL(v1, 17); v1 ^= v2; v2 = ROTL(v2, 32); \
-    } while(0)
-
-uint64_t UltimateHybridHash::siphash_stage(const std::string& key) const {
-    const uint8_t* in = reinterpret_cast<const uint8_t*>(key.data());
-    size_t inlen = key.size();
-    
-    uint64_t v0 = 0x736f6d6570736575ULL;
-    uint64_t v1 = 0x646f72616e646f6dULL;
-    uint64_t v2 = 0x6c7967656e657261ULL;
-    uint64_t v3 = 0x7465646279746573ULL;
-    uint64_t b = ((uint64_t)inlen) << 56;
-    
-    v3 ^= sip_key1;
-    v2 ^= sip_key0;
-    v1 ^= sip_key1;
-    v0 ^= sip_key0;
-    
-    const uint8_t* end = in + inlen - (inlen % sizeof(uint64_t));
-    
-    for (; in != end; in += 8) {
-        uint64_t m;
-        std::memcpy(&m, in, sizeof(m));
-        v3 ^= m;
-        SIPROUND; SIPROUND;
-        v0 ^= m;
-    }
-    
-    const int left = inlen & 7;
-    switch (left) {
-        case 7: b |= ((uint64_t)in[6]) << 48; [[fallthrough]];
-        case 6: b |= ((uint64_t)in[5]) << 40; [[fallthrough]];
-        case 5: b |= ((uint64_t)in[4]) << 32; [[fallthrough]];
-        case 4: b |= ((uint64_t)in[3]) << 24; [[fallthrough]];
-        case 3: b |= ((uint64_t)in[2]) << 16; [[fallthrough]];
-        case 2: b |= ((uint64_t)in[1]) << 8; [[fallthrough]];
-        case 1: b |= ((uint64_t)in[0]); break;
-        case 0: break;
-    }
-    
-    v3 ^= b;
-    SIPROUND; SIPROUND;
-    v0 ^= b;
-    v2 ^= 0xff;
-    SIPROUND; SIPROUND; SIPROUND; SIPROUND;
-    
-    return v0 ^ v1 ^ v2 ^ v3;
-}
-
-// Improved BLAKE3-like mixing function with better cryptographic properties
-uint64_t UltimateHybridHash::blake3_stage(const std::string& key) const {
-    const uint32_t IV[8] = {
-        0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
-        0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
-    };
-
-    uint32_t state[8];
-    std::memcpy(state, IV, sizeof(state));
-
-    // Improved mixing with multiple rounds for better avalanche effect
-    for (size_t i = 0; i < key.size(); i++) {
-        uint32_t c = static_cast<uint32_t>(key[i]);
-        size_t idx = i % 8;
-
-        // Better mixing with multiple rotations and XOR operations
-        state[idx] ^= c;
-        state[(idx + 1) % 8] ^= ROTL32(state[idx], 7);
-        state[(idx + 2) % 8] ^= ROTL32(state[idx], 13);
-        state[(idx + 3) % 8] ^= ROTL32(state[idx], 16);
-    }
-
-    // Final mixing round for better diffusion
-    for (int i = 0; i < 8; i++) {
-        state[i] = ROTL32(state[i], 11) ^ state[(i + 1) % 8];
-    }
-
-    // Use XOR of all state words for better collision resistance
-    uint64_t result = 0;
-    for (int i = 0; i < 8; i++) {
-        result ^= static_cast<uint64_t>(state[i]) << ((i % 2) * 32);
-    }
-    return result;
-}
-
-void UltimateHybridHash::compute_mphf_hashes(uint64_t preprocessed, size_t& h0, size_t& h1, size_t& h2) const {
-    // Use MurmurHash3 for high-quality, independent hash functions
-    // Convert preprocessed value to string for hashing
-    std::string preprocessed_str = std::to_string(preprocessed);
-    MurmurHash3::hash_triple(preprocessed_str, mphf_seeds[0], mphf_seeds[1], mphf_seeds[2],
-                             h0, h1, h2, table_size);
-}
-
-bool UltimateHybridHash::build_mphf(const std::vector<std::string>& keys) {
-    std::vector<std::vector<size_t>> edges(table_size);
-    std::vector<std::array<size_t, 3>> key_edges(num_keys);
-    std::vector<uint64_t> preprocessed_keys(num_keys);
-    
-    for (size_t i = 0; i < num_keys; i++) {
-        preprocessed_keys[i] = siphash_stage(keys[i]);
-        size_t h0, h1, h2;
-        compute_mphf_hashes(preprocessed_keys[i], h0, h1, h2);
-        
-        key_edges[i][0] = h0;
-        key_edges[i][1] = h1;
-        key_edges[i][2] = h2;
-        edges[h0].push_back(i);
-        edges[h1].push_back(i);
-        edges[h2].push_back(i);
-    }
-    
-    // Peeling algorithm
-    std::queue<size_t> queue;
-    std::vector<int> degree(table_size);
-    
-    for (size_t v = 0; v < table_size; v++) {
-        degree[v] = static_cast<int>(edges[v].size());
-        if (degree[v] == 1) queue.push(v);
-    }
-    
-    std::vector<bool> visited(num_keys, false);
-    std::vector<size_t> ordering;
-    
-    while (!queue.empty()) {
-        size_t v = queue.front();
-        queue.pop();
-        
-        if (degree[v] == 0) continue;
-        
-        size_t key_idx = table_size;
-        for (size_t k : edges[v]) {
-            if (!visited[k]) {
-                key_idx = k;
-                break;
-            }
-        }
-        
-        if (key_idx == table_size) continue;
-        
-        visited[key_idx] = true;
-        ordering.push_back(key_idx);
-        
-        for (size_t j = 0; j < 3; j++) {
-            size_t vertex = key_edges[key_idx][j];
-            degree[vertex]--;
-            if (degree[vertex] == 1) queue.push(vertex);
-        }
-    }
-    
-    if (ordering.size() != num_keys) return false;
-    
-    // Assign g-values
-    std::vector<int> assigned(table_size, -1);
-    g_table.clear();
-    g_table.resize((table_size + 3) / 4, 0);
-    
-    for (auto it = ordering.rbegin(); it != ordering.rend(); ++it) {
-        size_t key_idx = *it;
-        auto& edge = key_edges[key_idx];
-        
-        for (uint8_t g = 0; g < 3; g++) {
-            size_t sum = 0;
-            for (size_t j = 0; j < 3; j++) {
-                size_t v = edge[j];
-                if (assigned[v] == -1) {
-                    assigned[v] = g;
-                    size_t byte_idx = v / 4;
-                    size_t bit_offset = (v % 4) * 2;
-                    g_table[byte_idx] |= (g & 0x03) << bit_offset;
-                    sum += g;
-                    break;
-                } else {
-                    sum += assigned[v];
-                }
-            }
-            if ((sum % 3) == (key_idx % 3)) break;
-        }
-    }
-    
-    return true;
-}
-
-double UltimateHybridHash::compute_chi_square(const std::vector<std::string>& keys) const {
-    // Compute chi-square statistic for hash distribution quality
-    // Tests if hash values are uniformly distributed across buckets
-    std::vector<size_t> bucket_counts(num_keys, 0);
-
-    for (const auto& key : keys) {
-        uint64_t h = hash(key);
-        if (h < num_keys) {
-            bucket_counts[h]++;
-        }
-    }
-
-    double expected = static_cast<double>(keys.size()) / num_keys;
-    double chi_square = 0.0;
-
-    for (size_t count : bucket_counts) {
-        double diff = count - expected;
-        chi_square += (diff * diff) / expected;
-    }
-
-    return chi_square;
-}
-
-void UltimateHybridHash::build(const std::vector<std::string>& keys) {
-    num_keys = keys.size();
-    table_size = static_cast<size_t>(1.23 * num_keys);
-
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-
-    sip_key0 = gen();
-    sip_key1 = gen();
-    mphf_seeds[0] = gen();
-    mphf_seeds[1] = gen();
-    mphf_seeds[2] = gen();
-
-    // Initialize construction statistics
-    construction_stats = ConstructionStats();
-
-    // Build MPHF
-    bool success = false;
-    for (int attempt = 0; attempt < 100 && !success; attempt++) {
-        construction_stats.attempts++;
-        if (attempt > 0) {
-            mphf_seeds[0] = gen();
-            mphf_seeds[1] = gen();
-            mphf_seeds[2] = gen();
-        }
-        success = build_mphf(keys);
-    }
-
-    construction_stats.success = success;
-
-    if (!success) {
-        std::cerr << "Warning: Ultimate Hybrid MPHF construction failed after 100 attempts\\n";
-    }
-    
-    // Compute BLAKE3 fingerprints
-    blake3_fingerprints.resize(num_keys);
-    for (size_t i = 0; i < num_keys; i++) {
-        blake3_fingerprints[i] = blake3_stage(keys[i]);
-    }
-
-    // Cache-optimized storage
-    size_t num_blocks = (num_keys + 7) / 8;
-    cache_optimized_storage.resize(num_blocks);
-
-    for (size_t i = 0; i < num_keys; i++) {
-        size_t block_idx = i / 8;
-        size_t offset = i % 8;
-        cache_optimized_storage[block_idx].fingerprints[offset] = blake3_fingerprints[i];
-    }
-
-    // Compute chi-square statistic for successful builds
-    if (success) {
-        construction_stats.chi_square = compute_chi_square(keys);
-    }
-}
-
-size_t UltimateHybridHash::mphf_stage(uint64_t preprocessed) const {
-    size_t h0, h1, h2;
-    compute_mphf_hashes(preprocessed, h0, h1, h2);
-    
-    auto get_g = [this](size_t idx) -> uint8_t {
-        size_t byte_idx = idx / 4;
-        size_t bit_offset = (idx % 4) * 2;
-        return (g_table[byte_idx] >> bit_offset) & 0x03;
-    };
-    
-    return (get_g(h0) + get_g(h1) + get_g(h2)) % num_keys;
-}
-
-bool UltimateHybridHash::verify_lookup(const std::string& key, size_t index) const {
-    if (index >= num_keys) return false;
-    
-    uint64_t expected_fp = blake3_stage(key);
-    size_t block_idx = index / 8;
-    size_t offset = index % 8;
-    
-    return cache_optimized_storage[block_idx].fingerprints[offset] == expected_fp;
-}
-
-uint64_t UltimateHybridHash::hash(const std::string& key) const {
-    // Stage 1: SipHash preprocessing
-    uint64_t stage1 = siphash_stage(key);
-
-    // Stage 2: MPHF lookup with prefetching
-    size_t h0, h1, h2;
-    compute_mphf_hashes(stage1, h0, h1, h2);
-
-    // Prefetch g-table entries to reduce memory latency
-    __builtin_prefetch(&g_table[h0 / 4], 0, 1);
-    __builtin_prefetch(&g_table[h1 / 4], 0, 1);
-    __builtin_prefetch(&g_table[h2 / 4], 0, 1);
-
-    size_t stage2 = mphf_stage(stage1);
-
-    // Prefetch fingerprint before verification
-    size_t block_idx = stage2 / 8;
-    if (block_idx < cache_optimized_storage.size()) {
-        __builtin_prefetch(&cache_optimized_storage[block_idx], 0, 1);
-    }
-
-    // Stage 3: Verification
-    if (verify_lookup(key, stage2)) {
-        return stage2;
-    }
-
-    return UINT64_MAX;  // Verification failed
-}
-
-size_t UltimateHybridHash::getMemoryUsage() const {
-    return sizeof(*this) + g_table.capacity() + 
-           blake3_fingerprints.capacity() * sizeof(uint64_t) +
-           cache_optimized_storage.capacity() * sizeof(CacheBlock);
-}
-
 void UltimateHybridHash::printStats() const {
+    const FingerprintArray& fingerprints = verifier.fingerprints();
+
     std::cout << "  Architecture: 4-stage hybrid\n";
     std::cout << "    Stage 1: SipHash-2-4 (DoS resistance)\n";
     std::cout << "    Stage 2: BDZ MPHF (perfect hashing)\n";
     std::cout << "    Stage 3: BLAKE3 verification (security)\n";
     std::cout << "    Stage 4: Cache-line optimization\n";
-    std::cout << "  MPHF table size: " << table_size << "\n";
+    std::cout << "  MPHF table size: " << mphf.tableSize() << "\n";
     std::cout << "  Memory per key: " << (getMemoryUsage() * 8.0 / num_keys) << " bits\n";
-    std::cout << "  Cache blocks: " << cache_optimized_storage.size() << "\n";
+    std::cout << "  Fingerprints: " << fingerprints.width() << " bits/key, "
+              << (fingerprints.sizeInBytes() + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE << " cache lines\n";
+    printKeyStoreStats();
 
     if (construction_stats.success) {
         std::cout << "  Construction attempts: " << construction_stats.attempts << "\n";
-        std::cout << "  Chi-square statistic: " << std::fixed << std::setprecision(2)
-                  << construction_stats.chi_square << " (lower is better)\n";
-        std::cout << "  Expected χ² for uniform: ~" << (num_keys - 1) << "\n";
     }
 }
 
@@ -372,7 +37,9 @@ double UltimateHybridHash::getAverageProbeLength() const {
 }
 
 double UltimateHybridHash::getCacheEfficiency() const {
-    return 100.0 * CACHE_LINE_SIZE / sizeof(CacheBlock);
+    // Share of each cache line holding whole fingerprints
+    double per_line = CACHE_LINE_SIZE * 8.0 / verifier.fingerprints().width();
+    return 100.0 * std::floor(per_line) / per_line;
 }
 
 } // namespace hashing